@@ -0,0 +1,184 @@
+/*
+  ==============================================================================
+
+    This file contains the basic startup code for a JUCE application.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../Source/HostSimulation.h"
+
+namespace
+{
+
+int getIntOption (const juce::ArgumentList& args, const juce::String& option, int defaultValue)
+{
+    return args.containsOption (option) ? args.getValueForOption (option).getIntValue() : defaultValue;
+}
+
+HostSimulation::Config getConfig (const juce::ArgumentList& args)
+{
+    HostSimulation::Config config;
+    config.numInstances = getIntOption (args, "--instances", config.numInstances);
+    config.numThreads = getIntOption (args, "--threads", config.numThreads);
+    config.blockSize = getIntOption (args, "--block", config.blockSize);
+    config.numCallbacks = getIntOption (args, "--callbacks", config.numCallbacks);
+
+    if (args.containsOption ("--rate"))
+        config.sampleRate = args.getValueForOption ("--rate").getDoubleValue();
+
+    return config;
+}
+
+void print (const juce::String& line)
+{
+    std::cout << line << std::endl;
+}
+
+} //end anonymous namespace
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    //apvts and the editor both want a message manager, and this thread is it
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::ConsoleApplication app;
+    app.addHelpCommand ("--help|-h", "Headless load tests for Project11. See Source/HostSimulation.h", true);
+
+    app.addCommand ({ "--run",
+                      "--run [--instances=N] [--threads=N] [--block=N] [--rate=R] [--callbacks=N]",
+                      "One configuration",
+                      "Constructs, prepares and processes the instances on a pool of worker threads and prints the result.",
+                      [] (const juce::ArgumentList& args)
+                      {
+                          print (HostSimulation::toString (HostSimulation::run (getConfig (args))));
+                      } });
+
+    app.addCommand ({ "--scan",
+                      "--scan [--instances=N]",
+                      "What a host scan or project load costs",
+                      "Constructs the instances, reads every parameter and saves state, then prints construction time and "
+                      "resident memory per instance. Run it in a Release build and a ReleaseEager build "
+                      "(PROJECT11_EAGER_INSTANTIATION=1, instantiation as it was before the constexpr tables and the lazy DSP "
+                      "state) for the before and after.",
+                      [] (const juce::ArgumentList& args)
+                      {
+                          print (HostSimulation::toString (HostSimulation::runScan (getIntOption (args, "--instances", 100))));
+                      } });
+
+    app.addCommand ({ "--render",
+                      "--render [--width=N] [--height=N] [--frames=N]",
+                      "Display frame times",
+                      "Paints the EQ display offscreen, rebuilding the response curve and the analyzer path every frame, "
+                      "and prints the mean and worst frame time.",
+                      [] (const juce::ArgumentList& args)
+                      {
+                          print (HostSimulation::toString (HostSimulation::runRenderBenchmark (getIntOption (args, "--width", 700),
+                                                                                               getIntOption (args, "--height", 400),
+                                                                                               getIntOption (args, "--frames", 600))));
+                      } });
+
+    app.addCommand ({ "--crossover",
+                      "--crossover [--rate=R] [--block=N] [--blocks=N]",
+                      "Crossover cost per band count",
+                      "Processes stereo noise through the crossover at 2 to 6 bands and prints ns per sample, per band and "
+                      "as a multiple of the plugin's L/R Filterchain over the same input.",
+                      [] (const juce::ArgumentList& args)
+                      {
+                          auto sampleRate = args.containsOption ("--rate") ? args.getValueForOption ("--rate").getDoubleValue() : 48000.0;
+
+                          for (const auto& cost : HostSimulation::runCrossoverBenchmark (sampleRate,
+                                                                                          getIntOption (args, "--block", 512),
+                                                                                          getIntOption (args, "--blocks", 20000)))
+                              print (HostSimulation::toString (cost));
+                      } });
+
+    app.addCommand ({ "--dynamics",
+                      "--dynamics [--rate=R] [--block=N] [--blocks=N]",
+                      "Dynamic band cost against a static band",
+                      "Processes stereo noise through a static Peak and through a compressing dynamic band at sub-blocks of "
+                      "32 and 128 samples, and prints ns per sample for each and the ratio. Then runs 8 compressing dynamic "
+                      "bands on stereo and exits with 1 if they take more than their CPU budget. See HostSimulation::DynamicBandCost.",
+                      [] (const juce::ArgumentList& args)
+                      {
+                          auto sampleRate = args.containsOption ("--rate") ? args.getValueForOption ("--rate").getDoubleValue() : 48000.0;
+                          bool withinBudget = true;
+
+                          for (const auto& cost : HostSimulation::runDynamicBandBenchmark (sampleRate,
+                                                                                            getIntOption (args, "--block", 512),
+                                                                                            getIntOption (args, "--blocks", 20000)))
+                          {
+                              print (HostSimulation::toString (cost));
+                              withinBudget = withinBudget && cost.withinBudget;
+                          }
+
+                          if (! withinBudget)
+                              juce::ConsoleApplication::fail ("dynamic bands over their CPU budget");
+                      } });
+
+    app.addCommand ({ "--match",
+                      "--match [--reference=FILE --mix=FILE] [--minutes=N] [--threads=N]",
+                      "Match EQ analysis time",
+                      "Runs the match EQ's analysis and fit on a reference and a mix and prints the wall time and the fitted band. "
+                      "Without files, writes a --minutes long pair (5 by default) to the temp folder first, where the reference is "
+                      "the mix through a +6dB Peak at 2kHz, and deletes it afterwards.",
+                      [] (const juce::ArgumentList& args)
+                      {
+                          auto reference = args.containsOption ("--reference") ? args.getExistingFileForOption ("--reference") : juce::File();
+                          auto mix = args.containsOption ("--mix") ? args.getExistingFileForOption ("--mix") : juce::File();
+                          const auto writePair = reference == juce::File() || mix == juce::File();
+
+                          if (writePair)
+                          {
+                              auto temp = juce::File::getSpecialLocation (juce::File::tempDirectory);
+                              reference = temp.getNonexistentChildFile ("Project11_match_reference", ".wav");
+                              mix = temp.getNonexistentChildFile ("Project11_match_mix", ".wav");
+
+                              auto minutes = args.containsOption ("--minutes") ? args.getValueForOption ("--minutes").getDoubleValue() : 5.0;
+
+                              juce::String error;
+                              if (! HostSimulation::writeMatchPair (reference, mix, minutes, error))
+                                  juce::ConsoleApplication::fail (error);
+                          }
+
+                          print (HostSimulation::toString (HostSimulation::runMatch (reference, mix, getIntOption (args, "--threads", 0))));
+
+                          if (writePair)
+                          {
+                              reference.deleteFile();
+                              mix.deleteFile();
+                          }
+                      } });
+
+    app.addCommand ({ "--test-designs",
+                      "--test-designs",
+                      "Tests the analog matched design",
+                      "Designs every Peak and shelf the parameters allow at 44.1, 48 and 96kHz and checks each against the analog "
+                      "prototype and the bilinear design. Exits with 1 if any design fails. See HostSimulation::testDesigns().",
+                      [] (const juce::ArgumentList&)
+                      {
+                          auto result = HostSimulation::testDesigns();
+                          print (HostSimulation::toString (result));
+
+                          if (result.numFailures > 0)
+                              juce::ConsoleApplication::fail (juce::String (result.numFailures) + " designs failed");
+                      } });
+
+    juce::ConsoleApplication::Command sweep { "--sweep",
+                                              "--sweep [--instances=N] [--threads=N] [--block=N] [--rate=R] [--callbacks=N]",
+                                              "Thread scaling sweep (the default)",
+                                              "Runs the configuration at 1, 2, 4 ... threads up to --threads (all cores by default).",
+                                              [] (const juce::ArgumentList& args)
+                                              {
+                                                  HostSimulation::runScalingSweep (getConfig (args), [] (const HostSimulation::Result& result)
+                                                  {
+                                                      print (HostSimulation::toString (result));
+                                                  });
+                                              } };
+    app.addCommand (sweep);
+    app.addDefaultCommand (sweep);
+
+    return app.findAndRunCommand (argc, argv);
+}
@@ -0,0 +1,346 @@
+/*
+  ==============================================================================
+
+    AutoGain.cpp
+    Created: 18 Oct 2026 11:02:17am
+    Author:  Marc Woodbury-Smith
+
+  ==============================================================================
+*/
+
+#include "AutoGain.h"
+
+namespace
+{
+//|H(e^jw)|^2 of a single biquad, a0 not necessarily 1
+double biquadPower(double b0, double b1, double b2, double a0, double a1, double a2, double omega)
+{
+    const std::complex<double> z1 = std::polar(1.0, -omega);
+    const std::complex<double> z2 = z1 * z1;
+
+    const auto numerator = b0 + b1 * z1 + b2 * z2;
+    const auto denominator = a0 + a1 * z1 + a2 * z2;
+
+    return std::norm(numerator) / std::norm(denominator);
+}
+} //end anonymous namespace
+
+AutoGain::AutoGain()
+{
+}
+
+AutoGain::~AutoGain()
+{
+    release();
+}
+
+//==============================================================================
+
+void AutoGain::prepare(double sampleRate)
+{
+    release();
+
+    const auto minFreq = 20.0;
+    const auto maxFreq = juce::jmin(20000.0, sampleRate * 0.49);
+
+    gridSampleRate = sampleRate;
+    totalWeight = 0.0;
+
+    for (int i = 0; i < numGridPoints; ++i)
+    {
+        auto freq = juce::mapToLog10(static_cast<double>(i) / (numGridPoints - 1), minFreq, maxFreq);
+
+        gridOmega[static_cast<size_t>(i)] = juce::MathConstants<double>::twoPi * freq / sampleRate;
+        gridWeight[static_cast<size_t>(i)] = getKWeightingPower(freq, sampleRate);
+        totalWeight += gridWeight[static_cast<size_t>(i)];
+    }
+
+    //force a fresh analysis of whatever response is pending at the new rate
+    analysedVersion = responseVersion.load() - 1;
+
+    worker->add(*this);
+    worker->notify();
+}
+
+void AutoGain::release()
+{
+    worker->remove(*this);
+}
+
+//==============================================================================
+
+AutoGain::Section AutoGain::toSection(const juce::dsp::IIR::Coefficients<float>& coefficients)
+{
+    //juce stores the coefficients already divided by a0: b0 b1 a1 for first order, b0 b1 b2 a1 a2 for second order
+    const auto* raw = coefficients.getRawCoefficients();
+
+    Section section;
+
+    if (coefficients.getFilterOrder() == 1)
+    {
+        section.b0 = raw[0];
+        section.b1 = raw[1];
+        section.a1 = raw[2];
+    }
+    else
+    {
+        section.b0 = raw[0];
+        section.b1 = raw[1];
+        section.b2 = raw[2];
+        section.a1 = raw[3];
+        section.a2 = raw[4];
+    }
+
+    return section;
+}
+
+void AutoGain::setResponse(const Section* sections, int numSections)
+{
+    staged.numSections = juce::jmin(numSections, maxSections);
+    std::copy(sections, sections + staged.numSections, staged.sections.begin());
+    stagedIsPending = true;
+
+    publishPending();
+}
+
+void AutoGain::setResponse(const juce::dsp::IIR::Coefficients<float>& coefficients, bool bypassed)
+{
+    //a bypassed filter is a flat response, which is no sections at all
+    auto section = toSection(coefficients);
+    setResponse(&section, bypassed ? 0 : 1);
+}
+
+void AutoGain::setCrossover(int numBands, const float* frequencies, const float* gains)
+{
+    numBands = juce::jlimit(0, Crossover::maxBands, numBands);
+
+    std::array<float, Crossover::maxBands - 1> newFrequencies {};
+    std::array<float, Crossover::maxBands> newGains {};
+    if (numBands > 0)
+    {
+        std::copy(frequencies, frequencies + numBands - 1, newFrequencies.begin());
+        std::copy(gains, gains + numBands, newGains.begin());
+    }
+
+    if (numBands == staged.numBands && newFrequencies == staged.crossoverFrequencies && newGains == staged.bandGains)
+        return;
+
+    staged.numBands = numBands;
+    staged.crossoverFrequencies = newFrequencies;
+    staged.bandGains = newGains;
+    stagedIsPending = true;
+
+    publishPending();
+}
+
+void AutoGain::publishPending()
+{
+    if (!stagedIsPending)
+        return;
+
+    const juce::SpinLock::ScopedTryLockType lock(pendingLock);
+    if (!lock.isLocked())
+        return;
+
+    pending = staged;
+    stagedIsPending = false;
+
+    responseVersion.fetch_add(1, std::memory_order_release);
+    worker->notify();
+}
+
+//==============================================================================
+
+AutoGain::Worker::Worker() : juce::Thread("Project11 AutoGain")
+{
+    startThread();
+}
+
+AutoGain::Worker::~Worker()
+{
+    stopThread(1000);
+}
+
+void AutoGain::Worker::add(AutoGain& autoGain)
+{
+    const juce::ScopedLock sl(lock);
+    instances.addIfNotAlreadyThere(&autoGain);
+}
+
+void AutoGain::Worker::remove(AutoGain& autoGain)
+{
+    const juce::ScopedLock sl(lock);
+    instances.removeFirstMatchingValue(&autoGain);
+}
+
+void AutoGain::Worker::notify() noexcept
+{
+    //just a flag, the worker looks at every instance each time it finds it set
+    workPending.store(true, std::memory_order_release);
+}
+
+void AutoGain::Worker::run()
+{
+    while (!threadShouldExit())
+    {
+        wait(pollIntervalMs);
+
+        //cleared before looking, so a handover that lands during the sweep is picked up on the next poll
+        if (!workPending.exchange(false, std::memory_order_acq_rel))
+            continue;
+
+        const juce::ScopedLock sl(lock);
+
+        for (auto* autoGain : instances)
+        {
+            if (threadShouldExit())
+                break;
+
+            autoGain->analysePending();
+        }
+    }
+}
+
+void AutoGain::analysePending()
+{
+    auto version = responseVersion.load(std::memory_order_acquire);
+    if (version == analysedVersion)
+        return;
+
+    Response response;
+    {
+        const juce::SpinLock::ScopedLockType lock(pendingLock);
+        response = pending;
+        version = responseVersion.load(std::memory_order_relaxed);
+    }
+
+    analysedVersion = version;
+
+    loudnessChangeDb.store(static_cast<float>(computeLoudnessChangeDb(response)), std::memory_order_relaxed);
+}
+
+double AutoGain::computeLoudnessChangeDb(const Response& response) const
+{
+    if ((response.numSections == 0 && response.numBands == 0) || totalWeight <= 0.0)
+        return 0.0;
+
+    std::array<double, numGridPoints> crossoverPower;
+    computeCrossoverPower(response, crossoverPower);
+
+    double weightedPower = 0.0;
+
+    for (size_t i = 0; i < gridOmega.size(); ++i)
+    {
+        double power = crossoverPower[i];
+
+        for (int s = 0; s < response.numSections; ++s)
+        {
+            const auto& section = response.sections[static_cast<size_t>(s)];
+            power *= biquadPower(section.b0, section.b1, section.b2, 1.0, section.a1, section.a2, gridOmega[i]);
+        }
+
+        weightedPower += gridWeight[i] * power;
+    }
+
+    auto changeDb = 10.0 * std::log10(juce::jmax(weightedPower / totalWeight, 1.0e-12));
+
+    //cut filters can take almost everything away, compensating that fully would just blow up the noise floor
+    return juce::jlimit(-24.0, 24.0, changeDb);
+}
+
+void AutoGain::computeCrossoverPower(const Response& response, std::array<double, numGridPoints>& power) const
+{
+    if (response.numBands == 0)
+    {
+        power.fill(1.0);
+        return;
+    }
+
+    //the same LR4 designs Crossover::design() runs
+    const auto numCrossovers = response.numBands - 1;
+    std::array<SlopeDesign::Sections, Crossover::maxBands - 1> lowPasses, highPasses;
+
+    for (int c = 0; c < numCrossovers; ++c)
+    {
+        const auto freq = static_cast<double>(response.crossoverFrequencies[static_cast<size_t>(c)]);
+        SlopeDesign::design(SlopeDesign::LinkwitzRiley, false, 4, freq, gridSampleRate, lowPasses[static_cast<size_t>(c)]);
+        SlopeDesign::design(SlopeDesign::LinkwitzRiley, true, 4, freq, gridSampleRate, highPasses[static_cast<size_t>(c)]);
+    }
+
+    auto cascadeMagnitude = [] (const SlopeDesign::Sections& sections, double omega)
+    {
+        double cascadePower = 1.0;
+        for (int s = 0; s < sections.numSections; ++s)
+        {
+            const auto& section = sections.sections[static_cast<size_t>(s)];
+            cascadePower *= biquadPower(section.b0, section.b1, section.b2, 1.0, section.a1, section.a2, omega);
+        }
+        return std::sqrt(cascadePower);
+    };
+
+    for (size_t i = 0; i < gridOmega.size(); ++i)
+    {
+        //band k: the high passes below it, then its own low pass; the all-passes above it don't change |H|
+        double sum = 0.0;
+        double belowMagnitude = 1.0;
+
+        for (int band = 0; band < response.numBands; ++band)
+        {
+            auto bandMagnitude = belowMagnitude;
+
+            if (band < numCrossovers)
+            {
+                bandMagnitude *= cascadeMagnitude(lowPasses[static_cast<size_t>(band)], gridOmega[i]);
+                belowMagnitude *= cascadeMagnitude(highPasses[static_cast<size_t>(band)], gridOmega[i]);
+            }
+
+            sum += response.bandGains[static_cast<size_t>(band)] * bandMagnitude;
+        }
+
+        power[i] = sum * sum;
+    }
+}
+
+double AutoGain::getKWeightingPower(double freq, double sampleRate)
+{
+    /*BS.1770 K-weighting: a high shelf (+4dB above ~1.7kHz) followed by a high pass at ~38Hz.
+     The standard only gives the coefficients at 48kHz, these are the analog parameters behind them redesigned at sampleRate.*/
+    const auto omega = juce::MathConstants<double>::twoPi * freq / sampleRate;
+
+    double shelfPower = 0.0;
+    {
+        const auto gainDb = 3.999843853973347;
+        const auto fc = 1681.974450955533;
+        const auto q = 0.7071752369554196;
+
+        const auto A = std::pow(10.0, gainDb / 40.0);
+        const auto w0 = juce::MathConstants<double>::twoPi * fc / sampleRate;
+        const auto cosW0 = std::cos(w0);
+        const auto alpha = std::sin(w0) / (2.0 * q);
+        const auto sqrtA = std::sqrt(A);
+
+        shelfPower = biquadPower(A * ((A + 1) + (A - 1) * cosW0 + 2 * sqrtA * alpha),
+                                 -2 * A * ((A - 1) + (A + 1) * cosW0),
+                                 A * ((A + 1) + (A - 1) * cosW0 - 2 * sqrtA * alpha),
+                                 (A + 1) - (A - 1) * cosW0 + 2 * sqrtA * alpha,
+                                 2 * ((A - 1) - (A + 1) * cosW0),
+                                 (A + 1) - (A - 1) * cosW0 - 2 * sqrtA * alpha,
+                                 omega);
+    }
+
+    double highPassPower = 0.0;
+    {
+        const auto fc = 38.13547087602444;
+        const auto q = 0.5003270373238773;
+
+        const auto w0 = juce::MathConstants<double>::twoPi * fc / sampleRate;
+        const auto cosW0 = std::cos(w0);
+        const auto alpha = std::sin(w0) / (2.0 * q);
+
+        highPassPower = biquadPower((1 + cosW0) / 2, -(1 + cosW0), (1 + cosW0) / 2,
+                                    1 + alpha, -2 * cosW0, 1 - alpha,
+                                    omega);
+    }
+
+    return shelfPower * highPassPower;
+}
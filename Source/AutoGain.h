@@ -0,0 +1,134 @@
+/*
+  ==============================================================================
+
+    AutoGain.h
+    Created: 18 Oct 2026 11:02:17am
+    Author:  Marc Woodbury-Smith
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include "SlopeDesign.h"
+#include "Crossover.h"
+
+/*Loudness compensation worked out from the filter coefficients rather than by metering the output.
+
+ Whenever the audio thread hands over a new set of coefficients, a background thread integrates |H(f)|^2 over a log spaced
+ frequency grid, weighted by the BS.1770 K-weighting curve. A log spaced grid with equal weight per point is the same as
+ assuming pink programme material (equal energy per octave), which is close enough to a typical mix. The result is the
+ level change of the EQ in dB; the processor applies its negative through a smoothed gain stage, so there is no per sample
+ analysis at all.
+
+ The crossover's band gains count too. Its LR4 bands are all in phase with each other (that's what the all-pass
+ compensation is for, see Crossover.h), so their sum is sum(gain * |H_band|) and needs no phase.*/
+class AutoGain
+{
+public:
+    using Section = SlopeDesign::Section;
+
+    static constexpr int maxSections = 16;
+
+    AutoGain();
+    ~AutoGain();
+
+    //message thread. Rebuilds the weighting table for the new rate and (re)registers with the analysis thread.
+    void prepare(double sampleRate);
+    void release();
+
+    /*Audio thread, allocation free, never waits on the analysis. Hands the current response over as a cascade of sections.
+     If the analysis thread happens to be copying the previous response, the handover is retried by publishPending(),
+     which the processor calls once per block. A handover flags the analysis thread (Worker::notify()).*/
+    void setResponse(const Section* sections, int numSections);
+    void setResponse(const juce::dsp::IIR::Coefficients<float>& coefficients, bool bypassed);
+
+    /*Audio thread, same handover as setResponse(). The crossover after the EQ: numBands - 1 split frequencies and a linear
+     gain per band with mute and solo folded in, or numBands 0 when it's off. Cheap to call every block, only a change is
+     handed over.*/
+    void setCrossover(int numBands, const float* frequencies, const float* gains);
+
+    void publishPending();
+
+    //how much the current EQ changes the perceived level, in dB. Negate it to compensate.
+    float getLoudnessChangeDb() const noexcept { return loudnessChangeDb.load(std::memory_order_relaxed); }
+
+    static Section toSection(const juce::dsp::IIR::Coefficients<float>& coefficients);
+
+private:
+    /*One analysis thread for every AutoGain in the process, however many instances the host has loaded. It wakes every
+     pollIntervalMs and, if any instance has handed over a new response since, analyses whichever instances have one.
+     The audio thread only ever sets an atomic flag: signalling an event would take the event's mutex, and the audio
+     thread must never wait. A drag hands over a response every block, polling lets those pile up into one analysis.*/
+    class Worker : private juce::Thread
+    {
+    public:
+        Worker();
+        ~Worker() override;
+
+        //message thread
+        void add(AutoGain& autoGain);
+        void remove(AutoGain& autoGain);
+
+        //any thread, the audio thread included. Lock free.
+        void notify() noexcept;
+
+    private:
+        static constexpr int pollIntervalMs = 10;
+
+        void run() override;
+
+        //guards instances. Held while analysing, so remove() returns only once the worker is done with that instance.
+        juce::CriticalSection lock;
+        juce::Array<AutoGain*> instances;
+
+        std::atomic<bool> workPending {false};
+
+        JUCE_DECLARE_NON_COPYABLE (Worker)
+    };
+
+    static constexpr int numGridPoints = 256;
+
+    //everything one analysis needs
+    struct Response
+    {
+        std::array<Section, maxSections> sections {};
+        int numSections = 0;
+
+        int numBands = 0;
+        std::array<float, Crossover::maxBands - 1> crossoverFrequencies {};
+        std::array<float, Crossover::maxBands> bandGains {};
+    };
+
+    //worker thread
+    void analysePending();
+
+    double computeLoudnessChangeDb(const Response& response) const;
+    //|H|^2 of the crossover with its band gains, at each grid point
+    void computeCrossoverPower(const Response& response, std::array<double, numGridPoints>& power) const;
+    static double getKWeightingPower(double freq, double sampleRate);
+
+    //filled in prepare(), only read by the analysis thread
+    double gridSampleRate = 44100.0;
+    std::array<double, numGridPoints> gridOmega {};
+    std::array<double, numGridPoints> gridWeight {};
+    double totalWeight = 1.0;
+
+    //only touched by the audio thread
+    Response staged;
+    bool stagedIsPending = false;
+
+    //shared, guarded by pendingLock. The audio thread only ever try-locks it.
+    juce::SpinLock pendingLock;
+    Response pending;
+
+    std::atomic<uint32_t> responseVersion {0};
+    uint32_t analysedVersion = 0;
+
+    std::atomic<float> loudnessChangeDb {0.f};
+
+    juce::SharedResourcePointer<Worker> worker;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AutoGain)
+};
@@ -0,0 +1,144 @@
+/*
+  ==============================================================================
+
+    CascadeFilter.cpp
+    Created: 18 Oct 2026 5:48:12pm
+    Author:  Marc Woodbury-Smith
+
+  ==============================================================================
+*/
+
+#include "CascadeFilter.h"
+
+void CascadeFilter::prepare(int numChannelsToUse)
+{
+    jassert(numChannelsToUse <= maxChannels);
+    numChannels = juce::jlimit(0, maxChannels, numChannelsToUse);
+
+    reset();
+}
+
+void CascadeFilter::reset()
+{
+    state1.fill(Vec::expand(0.f));
+    state2.fill(Vec::expand(0.f));
+    scratch.fill(Vec::expand(0.f));
+}
+
+void CascadeFilter::setSections(const SlopeDesign::Sections& newSections) noexcept
+{
+    const auto newNumSections = juce::jlimit(0, SlopeDesign::maxSections, newSections.numSections);
+
+    for (int s = numSections; s < newNumSections; ++s)
+    {
+        state1[static_cast<size_t>(s)] = Vec::expand(0.f);
+        state2[static_cast<size_t>(s)] = Vec::expand(0.f);
+    }
+
+    std::copy(newSections.sections.begin(), newSections.sections.begin() + newNumSections, sections.begin());
+    numSections = newNumSections;
+    rampSamplesRemaining = 0;
+}
+
+void CascadeFilter::setSectionsRamped(const SlopeDesign::Sections& newSections, int numSamples) noexcept
+{
+    if (numSamples <= 1 || newSections.numSections != numSections)
+    {
+        setSections(newSections);
+        return;
+    }
+
+    //from wherever the last ramp got to
+    const auto scale = 1.f / static_cast<float>(numSamples);
+
+    for (int s = 0; s < numSections; ++s)
+    {
+        const auto& from = sections[static_cast<size_t>(s)];
+        const auto& to = newSections.sections[static_cast<size_t>(s)];
+        auto& step = steps[static_cast<size_t>(s)];
+
+        step.b0 = (to.b0 - from.b0) * scale;
+        step.b1 = (to.b1 - from.b1) * scale;
+        step.b2 = (to.b2 - from.b2) * scale;
+        step.a1 = (to.a1 - from.a1) * scale;
+        step.a2 = (to.a2 - from.a2) * scale;
+
+        rampTargets[static_cast<size_t>(s)] = to;
+    }
+
+    rampSamplesRemaining = numSamples;
+}
+
+void CascadeFilter::advanceRamp() noexcept
+{
+    //the last step lands exactly on the target, whatever rounding the increments picked up on the way
+    if (--rampSamplesRemaining == 0)
+    {
+        std::copy(rampTargets.begin(), rampTargets.begin() + numSections, sections.begin());
+        return;
+    }
+
+    for (int s = 0; s < numSections; ++s)
+    {
+        auto& c = sections[static_cast<size_t>(s)];
+        const auto& step = steps[static_cast<size_t>(s)];
+
+        c.b0 += step.b0;
+        c.b1 += step.b1;
+        c.b2 += step.b2;
+        c.a1 += step.a1;
+        c.a2 += step.a2;
+    }
+}
+
+void CascadeFilter::process(juce::dsp::AudioBlock<float>& block) noexcept
+{
+    const auto channelsToProcess = juce::jmin(numChannels, static_cast<int>(block.getNumChannels()));
+    if (numSections == 0 || channelsToProcess == 0)
+        return;
+
+    auto* interleaved = reinterpret_cast<float*>(scratch.data());
+    const auto totalSamples = static_cast<int>(block.getNumSamples());
+
+    for (int start = 0; start < totalSamples; start += chunkSize)
+    {
+        const auto numSamples = juce::jmin(chunkSize, totalSamples - start);
+
+        for (int channel = 0; channel < channelsToProcess; ++channel)
+        {
+            const auto* input = block.getChannelPointer(static_cast<size_t>(channel)) + start;
+            for (int i = 0; i < numSamples; ++i)
+                interleaved[i * maxChannels + channel] = input[i];
+        }
+
+        //the fused kernel: every section for one sample, then the next sample
+        for (int i = 0; i < numSamples; ++i)
+        {
+            if (rampSamplesRemaining > 0)
+                advanceRamp();
+
+            auto x = scratch[static_cast<size_t>(i)];
+
+            for (int s = 0; s < numSections; ++s)
+            {
+                const auto& c = sections[static_cast<size_t>(s)];
+                auto& s1 = state1[static_cast<size_t>(s)];
+                auto& s2 = state2[static_cast<size_t>(s)];
+
+                auto y = x * c.b0 + s1;
+                s1 = x * c.b1 - y * c.a1 + s2;
+                s2 = x * c.b2 - y * c.a2;
+                x = y;
+            }
+
+            scratch[static_cast<size_t>(i)] = x;
+        }
+
+        for (int channel = 0; channel < channelsToProcess; ++channel)
+        {
+            auto* output = block.getChannelPointer(static_cast<size_t>(channel)) + start;
+            for (int i = 0; i < numSamples; ++i)
+                output[i] = interleaved[i * maxChannels + channel];
+        }
+    }
+}
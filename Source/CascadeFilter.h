@@ -0,0 +1,62 @@
+/*
+  ==============================================================================
+
+    CascadeFilter.h
+    Created: 18 Oct 2026 5:48:12pm
+    Author:  Marc Woodbury-Smith
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "SlopeDesign.h"
+
+/*Runs a whole SlopeDesign::Sections cascade in one pass, with the channels side by side in the lanes of one SIMD register.
+
+ A ProcessorChain of IIR::Filters walks the block once per section and once per channel. Here each sample goes through
+ every section before the next sample is touched, so the intermediate signal never leaves registers, and left and right
+ (up to SIMDRegister<float>::size() channels) share every multiply. A steep cut costs its section count and nothing else.
+
+ The block is interleaved into a small aligned scratch buffer a chunk at a time, so there's nothing to allocate.*/
+class CascadeFilter
+{
+public:
+    using Vec = juce::dsp::SIMDRegister<float>;
+
+    static constexpr int maxChannels = static_cast<int>(Vec::SIMDNumElements);
+
+    void prepare(int numChannels);
+    void reset();
+
+    //audio thread, no allocation. Sections that weren't running before start from silence.
+    void setSections(const SlopeDesign::Sections& newSections) noexcept;
+
+    /*Same, but the coefficients move to the new ones in a straight line over the next numSamples samples instead of
+     jumping, for modulation. A normalised biquad is stable inside a triangle in (a1, a2), which is convex, so every
+     point on the way between two stable designs is stable too. A different section count can't be ramped and jumps.*/
+    void setSectionsRamped(const SlopeDesign::Sections& newSections, int numSamples) noexcept;
+
+    void process(juce::dsp::AudioBlock<float>& block) noexcept;
+
+private:
+    void advanceRamp() noexcept;
+
+    static constexpr int chunkSize = 64;
+
+    int numChannels = 0;
+    int numSections = 0;
+
+    std::array<SlopeDesign::Section, SlopeDesign::maxSections> sections;
+
+    //per sample coefficient increments while a ramp is running
+    std::array<SlopeDesign::Section, SlopeDesign::maxSections> steps;
+    std::array<SlopeDesign::Section, SlopeDesign::maxSections> rampTargets;
+    int rampSamplesRemaining = 0;
+
+    //transposed direct form II state, one lane per channel
+    std::array<Vec, SlopeDesign::maxSections> state1;
+    std::array<Vec, SlopeDesign::maxSections> state2;
+
+    std::array<Vec, chunkSize> scratch;
+};
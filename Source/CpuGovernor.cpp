@@ -0,0 +1,85 @@
+/*
+  ==============================================================================
+
+    CpuGovernor.cpp
+    Created: 19 Oct 2026 7:05:44pm
+    Author:  Marc Woodbury-Smith
+
+  ==============================================================================
+*/
+
+#include "CpuGovernor.h"
+
+const char* CpuGovernor::getLevelName(int levelToName)
+{
+    switch (levelToName)
+    {
+        case Full:                  return "Full quality";
+        case HalfRateAnalyzer:      return "Analyzer at half rate";
+        case QuarterRateAnalyzer:   return "Analyzer at quarter rate";
+        case HalfRateDynamics:      return "Dynamics every 64 samples";
+        case QuarterRateDynamics:   return "Dynamics every 128 samples";
+        default:                    return "";
+    }
+}
+
+void CpuGovernor::prepare(double sampleRateToUse)
+{
+    sampleRate = sampleRateToUse;
+    reset();
+}
+
+void CpuGovernor::reset()
+{
+    smoothedLoad = 0.f;
+    pressureSeconds = 0.0;
+    level.store(Full);
+    load.store(0.f);
+}
+
+void CpuGovernor::blockStarted() noexcept
+{
+    startTicks = juce::Time::getHighResolutionTicks();
+}
+
+void CpuGovernor::blockFinished(int numSamples) noexcept
+{
+    if (numSamples <= 0 || sampleRate <= 0.0)
+        return;
+
+    const auto elapsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+    const auto blockSeconds = numSamples / sampleRate;
+
+    //one pole over smoothingSeconds, whatever the block size
+    const auto alpha = static_cast<float>(1.0 - std::exp(-blockSeconds / smoothingSeconds));
+    smoothedLoad += alpha * (static_cast<float>(elapsed / blockSeconds) - smoothedLoad);
+    load.store(smoothedLoad, std::memory_order_relaxed);
+
+    const auto pressure = smoothedLoad / budget;
+
+    if (pressure > stepDownPressure)
+        pressureSeconds = juce::jmax(0.0, pressureSeconds) + blockSeconds;
+    else if (pressure < stepUpPressure)
+        pressureSeconds = juce::jmin(0.0, pressureSeconds) - blockSeconds;
+    else
+        pressureSeconds = 0.0;
+
+    const auto current = level.load(std::memory_order_relaxed);
+
+    //whatever the level was shedding isn't running any more
+    if (current > deepestLevel)
+    {
+        level.store(deepestLevel, std::memory_order_relaxed);
+        pressureSeconds = 0.0;
+    }
+    else if (pressureSeconds >= stepDownSeconds && current < deepestLevel)
+    {
+        level.store(current + 1, std::memory_order_relaxed);
+        pressureSeconds = 0.0;
+    }
+    else if (pressureSeconds <= -stepUpSeconds && current > Full)
+    {
+        level.store(current - 1, std::memory_order_relaxed);
+        pressureSeconds = 0.0;
+    }
+}
@@ -0,0 +1,92 @@
+/*
+  ==============================================================================
+
+    CpuGovernor.h
+    Created: 19 Oct 2026 7:05:44pm
+    Author:  Marc Woodbury-Smith
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+
+/*Watches how long processBlock takes against the real time the block lasts and, under sustained pressure, steps the
+ optional work down one level at a time:
+
+     Full                 everything at full quality
+     HalfRateAnalyzer     the analyzer collects every other FFT frame
+     QuarterRateAnalyzer  every fourth
+     HalfRateDynamics     the dynamic band re-evaluates its gain every 64 samples instead of 32
+     QuarterRateDynamics  every 128
+
+ The analyzer goes first: its feed (the mono sum into SampleFifo) runs inside processBlock, and a frame it skips is
+ also an FFT the editor doesn't run, while nobody hears it. The dynamic band's smoothing resolution is next. There's no
+ oversampling or linear phase kernel in this plugin to shorten.
+
+ Every level sheds work inside processBlock, so stepping down shows up in the load it's measuring. Levels for work
+ that isn't running (no editor open, no dynamic band) would shed nothing, so the processor tells the governor the
+ deepest level that still helps through setDeepestLevel() and it doesn't climb past it for no relief. With the editor
+ closed and the dynamic band compressing, it passes through the two analyzer levels on the way down, stepDownSeconds
+ each.
+
+ Down is quick (pressure held for stepDownSeconds), up is slow (relaxed for stepUpSeconds) and needs the load well below
+ the point where it stepped down, so it doesn't flap. Neither change can be heard: the analyzer only drops whole
+ frames, and the dynamic band carries its envelope across a sub-block size change, see DynamicBand::setSubBlockSize().
+
+ budget is the share of each block this instance is allowed before it counts as pressure. An instance can't see the
+ rest of the session, so that's a guess about how many instances share the core; the processor sets it from the
+ CPU_budget parameter (25% by default, a handful of instances).
+
+ Audio thread: blockStarted()/blockFinished(), setBudget(), setDeepestLevel(). Anyone: getLevel(), getLoad().*/
+class CpuGovernor
+{
+public:
+    enum Level
+    {
+        Full,
+        HalfRateAnalyzer,
+        QuarterRateAnalyzer,
+        HalfRateDynamics,
+        QuarterRateDynamics,
+        numLevels
+    };
+
+    static const char* getLevelName(int level);
+
+    void prepare(double sampleRate);
+    void reset();
+
+    void setBudget(float fractionOfBlock) noexcept { budget = juce::jlimit(0.01f, 1.f, fractionOfBlock); }
+
+    //the deepest level that would shed anything right now. Below the current level, it drops there when the block finishes.
+    void setDeepestLevel(int newDeepestLevel) noexcept { deepestLevel = juce::jlimit(static_cast<int>(Full), numLevels - 1, newDeepestLevel); }
+
+    void blockStarted() noexcept;
+    void blockFinished(int numSamples) noexcept;
+
+    int getLevel() const noexcept { return level.load(std::memory_order_relaxed); }
+
+    //smoothed processBlock time as a fraction of the block's real time
+    float getLoad() const noexcept { return load.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr float stepDownPressure = 1.f;
+    static constexpr float stepUpPressure = 0.5f;
+    static constexpr double stepDownSeconds = 0.25;
+    static constexpr double stepUpSeconds = 2.0;
+    static constexpr double smoothingSeconds = 0.2;
+
+    double sampleRate = 44100.0;
+    float budget = 0.25f;
+    int deepestLevel = numLevels - 1;
+
+    juce::int64 startTicks = 0;
+    float smoothedLoad = 0.f;
+    //how long the current pressure (positive) or calm (negative) has lasted
+    double pressureSeconds = 0.0;
+
+    std::atomic<int> level {Full};
+    std::atomic<float> load {0.f};
+};
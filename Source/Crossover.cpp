@@ -0,0 +1,193 @@
+/*
+  ==============================================================================
+
+    Crossover.cpp
+    Created: 19 Oct 2026 10:21:48am
+    Author:  Marc Woodbury-Smith
+
+  ==============================================================================
+*/
+
+#include "Crossover.h"
+#include "Trace.h"
+
+void Crossover::prepare(double sampleRateToUse, int numChannelsToUse)
+{
+    sampleRate = sampleRateToUse;
+    numChannels = juce::jlimit(0, maxChannels, numChannelsToUse);
+
+    //force a redesign on the next setCrossovers()
+    numBands = 0;
+    targetGains.fill(1.f);
+    currentGains.fill(1.f);
+
+    reset();
+}
+
+void Crossover::reset()
+{
+    for (auto& state : states)
+    {
+        state.lowPass1.fill(Vec::expand(0.f));
+        state.lowPass2.fill(Vec::expand(0.f));
+        state.highPass1.fill(Vec::expand(0.f));
+        state.highPass2.fill(Vec::expand(0.f));
+        state.allPass1 = Vec::expand(0.f);
+        state.allPass2 = Vec::expand(0.f);
+    }
+
+    scratch.fill(Vec::expand(0.f));
+}
+
+void Crossover::setCrossovers(int newNumBands, const float* frequencies) noexcept
+{
+    newNumBands = juce::jlimit(minBands, maxBands, newNumBands);
+
+    std::array<float, maxBands - 1> newFrequencies {};
+    auto lowest = 20.f;
+    auto highest = static_cast<float>(sampleRate * 0.45);
+
+    for (int i = 0; i < newNumBands - 1; ++i)
+    {
+        newFrequencies[static_cast<size_t>(i)] = juce::jlimit(lowest, highest, frequencies[i]);
+
+        //splits bunched up under the top run out of room; they stack at highest and the bands between them are empty
+        lowest = juce::jmin(newFrequencies[static_cast<size_t>(i)] * 1.01f, highest);
+    }
+
+    if (newNumBands == numBands && newFrequencies == crossoverFrequencies)
+        return;
+
+    //a different band count changes what each crossover splits, their old state means nothing there
+    if (newNumBands != numBands)
+        reset();
+
+    numBands = newNumBands;
+    crossoverFrequencies = newFrequencies;
+
+    design();
+}
+
+void Crossover::setBandGains(const float* gains) noexcept
+{
+    std::copy(gains, gains + maxBands, targetGains.begin());
+}
+
+//==============================================================================
+
+namespace
+{
+
+//one transposed direct form II biquad on every lane
+inline Crossover::Vec processSection(const SlopeDesign::Section& c, Crossover::Vec& s1, Crossover::Vec& s2,
+                                     Crossover::Vec x) noexcept
+{
+    auto y = x * c.b0 + s1;
+    s1 = x * c.b1 - y * c.a1 + s2;
+    s2 = x * c.b2 - y * c.a2;
+    return y;
+}
+
+} //end anonymous namespace
+
+void Crossover::design() noexcept
+{
+    Trace::Scope scope {"Crossover::design"};
+
+    using namespace SlopeDesign;
+
+    for (int c = 0; c < numBands - 1; ++c)
+    {
+        const auto freq = static_cast<double>(crossoverFrequencies[static_cast<size_t>(c)]);
+        auto& split = splits[static_cast<size_t>(c)];
+
+        Sections lowPass, highPass;
+        SlopeDesign::design(LinkwitzRiley, false, 4, freq, sampleRate, lowPass);
+        SlopeDesign::design(LinkwitzRiley, true, 4, freq, sampleRate, highPass);
+
+        std::copy(lowPass.sections.begin(), lowPass.sections.begin() + 2, split.lowPass.begin());
+        std::copy(highPass.sections.begin(), highPass.sections.begin() + 2, split.highPass.begin());
+
+        //LR4 low + high is the all-pass with the poles of a 2nd order Butterworth: numerator is the denominator reversed
+        Sections butterworth;
+        SlopeDesign::design(Butterworth, false, 2, freq, sampleRate, butterworth);
+
+        const auto& pole = butterworth.sections[0];
+        split.allPass = { pole.a2, pole.a1, 1.f, pole.a1, pole.a2 };
+    }
+}
+
+void Crossover::process(juce::dsp::AudioBlock<float>& block) noexcept
+{
+    const auto channelsToProcess = juce::jmin(numChannels, static_cast<int>(block.getNumChannels()));
+    const auto totalSamples = static_cast<int>(block.getNumSamples());
+
+    if (numBands == 0 || channelsToProcess == 0 || totalSamples == 0)
+        return;
+
+    const auto numCrossovers = numBands - 1;
+
+    //per band gain ramps from where the last block left off to the new targets
+    std::array<float, maxBands> gainSteps {};
+    for (int band = 0; band < numBands; ++band)
+        gainSteps[static_cast<size_t>(band)] = (targetGains[static_cast<size_t>(band)] - currentGains[static_cast<size_t>(band)])
+                                                   / static_cast<float>(totalSamples);
+
+    auto* interleaved = reinterpret_cast<float*>(scratch.data());
+
+    for (int start = 0; start < totalSamples; start += chunkSize)
+    {
+        const auto numSamples = juce::jmin(chunkSize, totalSamples - start);
+
+        for (int channel = 0; channel < channelsToProcess; ++channel)
+        {
+            const auto* input = block.getChannelPointer(static_cast<size_t>(channel)) + start;
+            for (int i = 0; i < numSamples; ++i)
+                interleaved[i * lanes + channel] = input[i];
+        }
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            //above: what's left above the crossovers so far. sum: the bands below them, gained and phase aligned
+            auto above = scratch[static_cast<size_t>(i)];
+            auto sum = Vec::expand(0.f);
+
+            for (int c = 0; c < numCrossovers; ++c)
+            {
+                const auto& split = splits[static_cast<size_t>(c)];
+                auto& state = states[static_cast<size_t>(c)];
+
+                auto low = above;
+                for (size_t s = 0; s < split.lowPass.size(); ++s)
+                    low = processSection(split.lowPass[s], state.lowPass1[s], state.lowPass2[s], low);
+
+                for (size_t s = 0; s < split.highPass.size(); ++s)
+                    above = processSection(split.highPass[s], state.highPass1[s], state.highPass2[s], above);
+
+                //nothing below the first crossover to line up
+                if (c > 0)
+                    sum = processSection(split.allPass, state.allPass1, state.allPass2, sum);
+
+                auto& gain = currentGains[static_cast<size_t>(c)];
+                gain += gainSteps[static_cast<size_t>(c)];
+                sum += low * gain;
+            }
+
+            //the top band is whatever made it through every high pass
+            auto& topGain = currentGains[static_cast<size_t>(numCrossovers)];
+            topGain += gainSteps[static_cast<size_t>(numCrossovers)];
+
+            scratch[static_cast<size_t>(i)] = sum + above * topGain;
+        }
+
+        for (int channel = 0; channel < channelsToProcess; ++channel)
+        {
+            auto* output = block.getChannelPointer(static_cast<size_t>(channel)) + start;
+            for (int i = 0; i < numSamples; ++i)
+                output[i] = interleaved[i * lanes + channel];
+        }
+    }
+
+    //land exactly on the targets, whatever rounding the steps picked up
+    currentGains = targetGains;
+}
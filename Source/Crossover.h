@@ -0,0 +1,88 @@
+/*
+  ==============================================================================
+
+    Crossover.h
+    Created: 19 Oct 2026 10:21:48am
+    Author:  Marc Woodbury-Smith
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "SlopeDesign.h"
+
+/*2 to 6 band Linkwitz-Riley (24 dB/Oct) splitter with per band gain, mute and solo and a phase coherent sum.
+
+ Written as a tree: crossover c splits whatever is above crossover c - 1 into band c and the rest, so band k is the high
+ passes of every crossover below it and then its own low pass, and that high pass prefix is run once and shared by every
+ band above it. To line the phases up, the sum of the bands below crossover c goes through that crossover's all-pass
+ (LR4 low + high == all-pass) before band c is added on. Per crossover that's an LR4 low pass, an LR4 high pass and one
+ all-pass section, five biquads, so the cost grows with the number of crossovers rather than crossovers times bands.
+
+ Like CascadeFilter, the channels sit side by side in the lanes of one SIMD register, so left and right share every
+ multiply; the block is interleaved into a small aligned scratch buffer a chunk at a time.*/
+class Crossover
+{
+public:
+    using Vec = juce::dsp::SIMDRegister<float>;
+
+    static constexpr int minBands = 2;
+    static constexpr int maxBands = 6;
+    static constexpr int maxChannels = 2;
+
+    void prepare(double sampleRate, int numChannels);
+    void reset();
+
+    /*Audio thread, no allocation. frequencies holds numBands - 1 crossover points, low to high; anything out of order is
+     pushed up so the bands never overlap. Only redesigns when something actually changed.*/
+    void setCrossovers(int numBands, const float* frequencies) noexcept;
+
+    //Audio thread. Linear gains per band, mute and solo already folded in. Ramped across the next block.
+    void setBandGains(const float* gains) noexcept;
+
+    void process(juce::dsp::AudioBlock<float>& block) noexcept;
+
+    int getNumBands() const noexcept { return numBands; }
+
+    //getNumBands() - 1 of them, as clamped by setCrossovers()
+    const float* getCrossoverFrequencies() const noexcept { return crossoverFrequencies.data(); }
+
+private:
+    static constexpr int maxCrossovers = maxBands - 1;
+    static constexpr int lanes = static_cast<int>(Vec::SIMDNumElements);
+    static constexpr int chunkSize = 64;
+
+    static_assert(maxChannels <= lanes, "every channel needs a lane");
+
+    void design() noexcept;
+
+    double sampleRate = 44100.0;
+    int numChannels = 0;
+
+    int numBands = 0;
+    std::array<float, maxCrossovers> crossoverFrequencies {};
+
+    //LR4 is two sections each way
+    struct Split
+    {
+        std::array<SlopeDesign::Section, 2> lowPass, highPass;
+        SlopeDesign::Section allPass;
+    };
+
+    std::array<Split, maxCrossovers> splits;
+
+    //transposed direct form II state, one lane per channel
+    struct SplitState
+    {
+        std::array<Vec, 2> lowPass1, lowPass2, highPass1, highPass2;
+        Vec allPass1, allPass2;
+    };
+
+    std::array<SplitState, maxCrossovers> states;
+
+    std::array<Vec, chunkSize> scratch;
+
+    std::array<float, maxBands> targetGains {};
+    std::array<float, maxBands> currentGains {};
+};
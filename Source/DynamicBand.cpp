@@ -0,0 +1,252 @@
+/*
+  ==============================================================================
+
+    DynamicBand.cpp
+    Created: 19 Oct 2026 2:12:37pm
+    Author:  Marc Woodbury-Smith
+
+  ==============================================================================
+*/
+
+#include "DynamicBand.h"
+
+namespace
+{
+
+bool sameShape(const DynamicBand::Settings& lhs, const DynamicBand::Settings& rhs)
+{
+    return lhs.shape == rhs.shape && lhs.frequency == rhs.frequency && lhs.quality == rhs.quality;
+}
+
+bool sameBallistics(const DynamicBand::Settings& lhs, const DynamicBand::Settings& rhs)
+{
+    return lhs.attackMs == rhs.attackMs && lhs.releaseMs == rhs.releaseMs;
+}
+
+float ballisticsCoefficient(float timeMs, double sampleRate, int subBlockSize)
+{
+    //one step per sub-block, so the time constant is counted in sub-blocks
+    const auto subBlocks = juce::jmax(1.0e-3, static_cast<double>(timeMs) * 0.001 * sampleRate / subBlockSize);
+    return static_cast<float>(std::exp(-1.0 / subBlocks));
+}
+
+} //end anonymous namespace
+
+void DynamicBand::prepare(double sampleRateToUse, int numChannelsToUse)
+{
+    sampleRate = sampleRateToUse;
+    numChannels = juce::jmin(CascadeFilter::maxChannels, numChannelsToUse);
+
+    band.prepare(numChannels);
+    needsDesign = true;
+
+    //a size set before prepare(), so the ballistics below are worked out for it
+    applyPendingSubBlockSize();
+
+    reset();
+}
+
+void DynamicBand::reset()
+{
+    band.reset();
+    detectorState1 = 0.f;
+    detectorState2 = 0.f;
+    envelope = 0.f;
+    reductionDb = 0.f;
+}
+
+void DynamicBand::setSettings(const Settings& newSettings) noexcept
+{
+    const auto shapeChanged = needsDesign || !sameShape(newSettings, settings);
+    const auto ballisticsChanged = needsDesign || !sameBallistics(newSettings, settings);
+
+    settings = newSettings;
+    settings.ratio = juce::jmax(1.f, settings.ratio);
+    needsDesign = false;
+
+    if (shapeChanged)
+        updateDetector();
+
+    if (ballisticsChanged)
+        updateBallistics();
+}
+
+void DynamicBand::setSubBlockSize(int newSubBlockSize) noexcept
+{
+    pendingSubBlockSize = juce::jmax(1, newSubBlockSize);
+}
+
+void DynamicBand::process(juce::dsp::AudioBlock<float>& block, const juce::dsp::AudioBlock<float>& detector) noexcept
+{
+    const auto totalSamples = static_cast<int>(block.getNumSamples());
+    const auto slope = 1.f - 1.f / settings.ratio;
+
+    for (int start = 0; start < totalSamples; start += subBlockSize)
+    {
+        applyPendingSubBlockSize();
+
+        const auto numSamples = juce::jmin(subBlockSize, totalSamples - start);
+
+        const auto level = measure(detector, start, numSamples);
+        const auto coefficient = level > envelope ? attackCoefficient : releaseCoefficient;
+        envelope = level + coefficient * (envelope - level);
+
+        //mean square, so 10 log10 is the RMS level in dB
+        const auto levelDb = 10.f * std::log10(envelope + 1.0e-12f);
+        const auto over = levelDb - settings.thresholdInDecibels;
+        reductionDb = over > 0.f ? over * slope : 0.f;
+
+        //the coefficients slide from the last sub-block's design to this one across the sub-block, no steps to zipper on
+        updateBand(settings.gainInDecibels - reductionDb);
+        band.setSectionsRamped(bandSections, numSamples);
+
+        auto subBlock = block.getSubBlock(static_cast<size_t>(start), static_cast<size_t>(numSamples));
+        band.process(subBlock);
+    }
+}
+
+//==============================================================================
+
+void DynamicBand::updateDetector() noexcept
+{
+    const auto omega = juce::MathConstants<double>::twoPi * juce::jmax(2.0, static_cast<double>(settings.frequency)) / sampleRate;
+    const auto cosOmega = std::cos(omega);
+    const auto sinOmega = std::sin(omega);
+
+    cosW0 = static_cast<float>(cosOmega);
+    sinW0 = static_cast<float>(sinOmega);
+
+    //the detector listens where the band acts: around the peak, or below/above a shelf's corner
+    double b0, b1, b2, a0, a1, a2;
+
+    if (settings.shape == Peak)
+    {
+        const auto alpha = sinOmega / (2.0 * juce::jmax(0.01, static_cast<double>(settings.quality)));
+        b0 = alpha;           b1 = 0.0;             b2 = -alpha;
+        a0 = 1.0 + alpha;     a1 = -2.0 * cosOmega; a2 = 1.0 - alpha;
+    }
+    else
+    {
+        const auto alpha = sinOmega / juce::MathConstants<double>::sqrt2;
+        const auto isLow = settings.shape == LowShelf;
+        const auto edge = isLow ? (1.0 - cosOmega) : (1.0 + cosOmega);
+        b0 = edge * 0.5;      b1 = isLow ? edge : -edge;  b2 = edge * 0.5;
+        a0 = 1.0 + alpha;     a1 = -2.0 * cosOmega;       a2 = 1.0 - alpha;
+    }
+
+    detectorFilter.b0 = static_cast<float>(b0 / a0);
+    detectorFilter.b1 = static_cast<float>(b1 / a0);
+    detectorFilter.b2 = static_cast<float>(b2 / a0);
+    detectorFilter.a1 = static_cast<float>(a1 / a0);
+    detectorFilter.a2 = static_cast<float>(a2 / a0);
+}
+
+void DynamicBand::updateBallistics() noexcept
+{
+    attackCoefficient = ballisticsCoefficient(settings.attackMs, sampleRate, subBlockSize);
+    releaseCoefficient = ballisticsCoefficient(settings.releaseMs, sampleRate, subBlockSize);
+}
+
+void DynamicBand::applyPendingSubBlockSize() noexcept
+{
+    if (pendingSubBlockSize == subBlockSize)
+        return;
+
+    subBlockSize = pendingSubBlockSize;
+    updateBallistics();
+}
+
+MatchedDesign::Shape DynamicBand::getMatchedShape() const noexcept
+{
+    return settings.shape == Peak ? MatchedDesign::Peak
+                                  : (settings.shape == LowShelf ? MatchedDesign::LowShelf : MatchedDesign::HighShelf);
+}
+
+void DynamicBand::updateBand(float gainInDecibels) noexcept
+{
+    bandSections.numSections = 1;
+
+    if (settings.analogMatched)
+    {
+        bandSections.sections[0] = MatchedDesign::design(getMatchedShape(), settings.frequency, settings.quality, gainInDecibels,
+                                                         sampleRate, settings.matchedMethod);
+        return;
+    }
+
+    //same formulas as juce::dsp::IIR::Coefficients makePeakFilter/makeLowShelf/makeHighShelf, with the trig cached
+    const auto A = std::pow(10.f, gainInDecibels / 40.f);
+    const auto q = juce::jmax(0.01f, settings.quality);
+
+    float b0, b1, b2, a0, a1, a2;
+
+    if (settings.shape == Peak)
+    {
+        const auto alpha = sinW0 / (2.f * q);
+        b0 = 1.f + alpha * A;  b1 = -2.f * cosW0;  b2 = 1.f - alpha * A;
+        a0 = 1.f + alpha / A;  a1 = -2.f * cosW0;  a2 = 1.f - alpha / A;
+    }
+    else
+    {
+        const auto aMinus1 = A - 1.f;
+        const auto aPlus1 = A + 1.f;
+        const auto aMinus1TimesCos = aMinus1 * cosW0;
+        const auto beta = sinW0 * std::sqrt(A) / q;
+
+        if (settings.shape == LowShelf)
+        {
+            b0 = A * (aPlus1 - aMinus1TimesCos + beta);
+            b1 = A * 2.f * (aMinus1 - aPlus1 * cosW0);
+            b2 = A * (aPlus1 - aMinus1TimesCos - beta);
+            a0 = aPlus1 + aMinus1TimesCos + beta;
+            a1 = -2.f * (aMinus1 + aPlus1 * cosW0);
+            a2 = aPlus1 + aMinus1TimesCos - beta;
+        }
+        else
+        {
+            b0 = A * (aPlus1 + aMinus1TimesCos + beta);
+            b1 = A * -2.f * (aMinus1 + aPlus1 * cosW0);
+            b2 = A * (aPlus1 + aMinus1TimesCos - beta);
+            a0 = aPlus1 - aMinus1TimesCos + beta;
+            a1 = 2.f * (aMinus1 - aPlus1 * cosW0);
+            a2 = aPlus1 - aMinus1TimesCos - beta;
+        }
+    }
+
+    const auto a0Inverse = 1.f / a0;
+
+    auto& section = bandSections.sections[0];
+    section.b0 = b0 * a0Inverse;
+    section.b1 = b1 * a0Inverse;
+    section.b2 = b2 * a0Inverse;
+    section.a1 = a1 * a0Inverse;
+    section.a2 = a2 * a0Inverse;
+}
+
+float DynamicBand::measure(const juce::dsp::AudioBlock<float>& detector, int start, int numSamples) noexcept
+{
+    const auto detectorChannels = static_cast<int>(detector.getNumChannels());
+    numSamples = juce::jmin(numSamples, static_cast<int>(detector.getNumSamples()) - start);
+
+    if (detectorChannels == 0 || numSamples <= 0)
+        return 0.f;
+
+    const auto channelScale = 1.f / static_cast<float>(detectorChannels);
+    const auto& c = detectorFilter;
+    auto sumOfSquares = 0.f;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        auto x = 0.f;
+        for (int channel = 0; channel < detectorChannels; ++channel)
+            x += detector.getSample(channel, start + i);
+        x *= channelScale;
+
+        const auto y = c.b0 * x + detectorState1;
+        detectorState1 = c.b1 * x - c.a1 * y + detectorState2;
+        detectorState2 = c.b2 * x - c.a2 * y;
+
+        sumOfSquares += y * y;
+    }
+
+    return sumOfSquares / static_cast<float>(numSamples);
+}
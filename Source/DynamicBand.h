@@ -0,0 +1,110 @@
+/*
+  ==============================================================================
+
+    DynamicBand.h
+    Created: 19 Oct 2026 2:12:37pm
+    Author:  Marc Woodbury-Smith
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "CascadeFilter.h"
+#include "MatchedDesign.h"
+
+/*A Peak, LowShelf or HighShelf whose gain follows a compressor: above threshold the band's gain is pulled down by
+ (level - threshold) * (1 - 1/ratio) dB. That's a de-esser or a resonance tamer without a second plugin.
+
+ The level comes from the detector block (the main input, or the sidechain bus) through a band filter matching the
+ band's shape: band pass for Peak, low pass / high pass at the corner for the shelves. The detector works a sub-block at
+ a time: mean square over subBlockSize samples, attack/release ballistics, gain computer, then a new biquad that the
+ band's coefficients slide to, linearly, across the sub-block (CascadeFilter::setSectionsRamped()). The gain never
+ steps, so fast attacks don't zipper.
+
+ Why it's cheap to modulate: freq and Q only change when the user moves them, so sin/cos of w0 are cached and a new gain
+ is one pow, one sqrt and a handful of multiplies to get the coefficients (same formulas as the juce factories, without
+ the allocation). Per sample the band costs one biquad for all channels through CascadeFilter plus five coefficient
+ increments, and the mono sum and one scalar biquad for the detector; per sub-block, one pow and a sqrt. The target is
+ a dynamic band on stereo costing no more than two static bands, and 8 of them on stereo within 2% of a core in real time;
+ HostSimulation::runDynamicBandBenchmark() checks both.*/
+class DynamicBand
+{
+public:
+    enum Shape
+    {
+        Peak,
+        LowShelf,
+        HighShelf
+    };
+
+    struct Settings
+    {
+        Shape shape {Peak};
+        float frequency {1000.f};
+        float quality {1.f};
+        float gainInDecibels {0.f};
+        float thresholdInDecibels {-20.f};
+        float ratio {2.f};
+        float attackMs {5.f};
+        float releaseMs {100.f};
+        //MatchedDesign instead of the cached RBJ formulas: a few more exp/cos per sub-block, no cramping near Nyquist
+        bool analogMatched {false};
+        //picked for the static gain, off the audio thread (MatchedDesign::MethodPicker); it carries the reduction too
+        MatchedDesign::Method matchedMethod {MatchedDesign::ThreePointFit};
+    };
+
+    static constexpr int defaultSubBlockSize = 32;
+
+    void prepare(double sampleRate, int numChannels);
+    void reset();
+
+    /*How often the gain is re-evaluated. Coarser is cheaper. Can be called before any block, the new size takes over at
+     the next sub-block boundary, compressing or not: the envelope is a mean square, which doesn't care how many samples
+     went into it, so it carries straight on, and the ballistics are rescaled so the attack and release times stay the
+     same. The coefficients still slide across every sub-block, only the length of the slide changes.*/
+    void setSubBlockSize(int newSubBlockSize) noexcept;
+
+    //audio thread, no allocation. Cheap when nothing changed.
+    void setSettings(const Settings& newSettings) noexcept;
+
+    /*Filters block in place. detector can be block itself: each sub-block is measured before it's filtered, so it's the
+     dry input that drives the gain.*/
+    void process(juce::dsp::AudioBlock<float>& block, const juce::dsp::AudioBlock<float>& detector) noexcept;
+
+private:
+    void updateDetector() noexcept;
+    void updateBallistics() noexcept;
+    void applyPendingSubBlockSize() noexcept;
+    void updateBand(float gainInDecibels) noexcept;
+    MatchedDesign::Shape getMatchedShape() const noexcept;
+    float measure(const juce::dsp::AudioBlock<float>& detector, int start, int numSamples) noexcept;
+
+    double sampleRate = 44100.0;
+    int numChannels = 0;
+
+    Settings settings;
+    bool needsDesign = true;
+    int subBlockSize = defaultSubBlockSize;
+    int pendingSubBlockSize = defaultSubBlockSize;
+
+    //cached per freq/Q, so a gain change never touches trig
+    float cosW0 = 1.f;
+    float sinW0 = 0.f;
+
+    CascadeFilter band;
+    SlopeDesign::Sections bandSections;
+
+    //detector band filter, transposed direct form II on the mono sum
+    SlopeDesign::Section detectorFilter;
+    float detectorState1 = 0.f;
+    float detectorState2 = 0.f;
+
+    //ballistics run once per sub-block, on the mean square
+    float attackCoefficient = 0.f;
+    float releaseCoefficient = 0.f;
+    float envelope = 0.f;
+
+    //the last sub-block's reduction
+    float reductionDb = 0.f;
+};
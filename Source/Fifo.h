@@ -48,10 +48,10 @@ struct Fifo
     {
         static_assert( std::is_same_v<T, std::vector<float> >,
                 "prepare(numElements) should only be used when the Fifo is holding std::vector<float>");
-        for( auto& buffer : buffers )
+        for( auto& vec : buffer )
         {
-            buffer.clear();
-            buffer.resize(numElements, 0);
+            vec.clear();
+            vec.resize(numElements, 0);
         }
 
     }
@@ -60,33 +60,148 @@ struct Fifo
     {
         /*This function returns an object which contains the start indices and block sizes, and also automatically finishes the write operation when it goes out of scope.*/
         auto writeHandle = fifo.write(1);
-        if( write.blockSize1 > 0 )
+        if( writeHandle.blockSize1 > 0 )
         {
-            
+            /*For AudioBuffers of the size passed to prepare() this is a plain copy, no reallocation happens.*/
+            buffer[writeHandle.startIndex1] = t;
+            return true;
         }
         
-        buffer[writeHandle.startIndex1] = t;
-        
-        return true;
-        
+        return false;
     }
     
-    
     bool pull(T& t)
     {
+        auto readHandle = fifo.read(1);
+        if( readHandle.blockSize1 > 0 )
+        {
+            t = buffer[readHandle.startIndex1];
+            return true;
+        }
         
+        return false;
+    }
+    
+    int getNumAvailableForReading() const
+    {
+        return fifo.getNumReady();
     }
     
-    int getNumAvailableForReading() const;
-    int getAvailableSpace() const;
+    int getAvailableSpace() const
+    {
+        return fifo.getFreeSpace();
+    }
     
 private:
     /*
      The AbstactFifo object doesn't actually hold any data itself, but your FIFO class can use one of these to manage its position and status when reading or writing to it.*/
-//    juce::AbstractFifo fifo { Size };
-    
-
+    juce::AbstractFifo fifo { Size };
     
     //The actual audio buffer/vector
     std::array<T, Size> buffer;
 };
+
+//==============================================================================
+
+/*Collects the (mono summed) output of processBlock into fixed size blocks for the analyzer, whatever block size the host uses.
+ Every block pushed into the Fifo has the same size, so the copy in push() never allocates on the audio thread.
+ With a frame stride above 1 only every stride'th block is collected, the samples in between aren't even summed; that's
+ how the CPU governor turns the analyzer down.*/
+struct SampleFifo
+{
+    void prepare(int bufferSize)
+    {
+        prepared.set(false);
+        size.set(bufferSize);
+        
+        bufferToFill.setSize(1, bufferSize, false, true, true);
+        audioBufferFifo.prepare(bufferSize, 1);
+        fifoIndex = 0;
+        samplesToSkip = 0;
+        
+        prepared.set(true);
+    }
+    
+    void update(const juce::AudioBuffer<float>& buffer)
+    {
+        jassert(prepared.get());
+        
+        const auto numChannels = buffer.getNumChannels();
+        if( numChannels == 0 )
+            return;
+        
+        const auto channelScale = 1.f / static_cast<float>(numChannels);
+        
+        for( int i = 0; i < buffer.getNumSamples(); ++i )
+        {
+            if( samplesToSkip > 0 )
+            {
+                const auto skipped = juce::jmin(samplesToSkip, buffer.getNumSamples() - i);
+                samplesToSkip -= skipped;
+                i += skipped - 1;
+                continue;
+            }
+            
+            float sample = 0.f;
+            for( int channel = 0; channel < numChannels; ++channel )
+                sample += buffer.getSample(channel, i);
+            
+            pushNextSampleIntoFifo(sample * channelScale);
+        }
+    }
+    
+    //audio thread; the block being collected is finished first
+    void setFrameStride(int newFrameStride)
+    {
+        frameStride = juce::jmax(1, newFrameStride);
+    }
+    
+    int getNumCompleteBuffersAvailable() const
+    {
+        return audioBufferFifo.getNumAvailableForReading();
+    }
+    
+    bool getAudioBuffer(juce::AudioBuffer<float>& buf)
+    {
+        return audioBufferFifo.pull(buf);
+    }
+    
+    bool isPrepared() const
+    {
+        return prepared.get();
+    }
+    
+    int getSize() const
+    {
+        return size.get();
+    }
+    
+private:
+    void pushNextSampleIntoFifo(float sample)
+    {
+        if( fifoIndex == bufferToFill.getNumSamples() )
+        {
+            //if the editor isn't keeping up the block is dropped, the analyzer just skips a frame
+            audioBufferFifo.push(bufferToFill);
+            fifoIndex = 0;
+            
+            if( frameStride > 1 )
+            {
+                //this sample is the first of the ones skipped
+                samplesToSkip = (frameStride - 1) * bufferToFill.getNumSamples() - 1;
+                return;
+            }
+        }
+        
+        bufferToFill.setSample(0, fifoIndex, sample);
+        ++fifoIndex;
+    }
+    
+    int fifoIndex = 0;
+    int frameStride = 1;
+    int samplesToSkip = 0;
+    Fifo<juce::AudioBuffer<float>, 8> audioBufferFifo;
+    juce::AudioBuffer<float> bufferToFill;
+    juce::Atomic<bool> prepared = false;
+    juce::Atomic<int> size = 0;
+};
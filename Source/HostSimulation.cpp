@@ -0,0 +1,849 @@
+/*
+  ==============================================================================
+
+    HostSimulation.cpp
+    Created: 18 Oct 2026 2:40:05pm
+    Author:  Marc Woodbury-Smith
+
+  ==============================================================================
+*/
+
+#include "HostSimulation.h"
+#include "PluginProcessor.h"
+#include "ResponseCurveComponent.h"
+#include "MatchEQ.h"
+#include <thread>
+
+#if JUCE_LINUX
+ #include <unistd.h>
+#elif JUCE_MAC
+ #include <mach/mach.h>
+#endif
+
+namespace HostSimulation
+{
+
+namespace
+{
+
+/*A DAW style worker pool. runCallback() publishes a new generation, every worker (and the caller) then pulls instance
+ indices off one shared counter until they're all done. Workers spin between callbacks like real audio worker threads do,
+ so wake-up latency doesn't get counted as plugin cost.*/
+class WorkerPool
+{
+public:
+    WorkerPool(int numThreads, std::function<void(int)> processInstanceToUse)
+        : processInstance(std::move(processInstanceToUse))
+    {
+        for (int i = 1; i < numThreads; ++i)
+        {
+            workers.emplace_back([this] { workerLoop(); });
+        }
+    }
+
+    ~WorkerPool()
+    {
+        quit.store(true);
+        for (auto& worker : workers)
+            worker.join();
+    }
+
+    void runCallback(int numInstances)
+    {
+        /*remaining has to be armed before nextInstance is reset: a worker still on its way out of the previous callback
+         may already pick up work from this one.*/
+        totalInstances.store(numInstances, std::memory_order_relaxed);
+        remaining.store(numInstances, std::memory_order_seq_cst);
+        nextInstance.store(0, std::memory_order_seq_cst);
+        generation.fetch_add(1, std::memory_order_release);
+
+        drain();
+
+        while (remaining.load(std::memory_order_acquire) > 0)
+        {
+            //the last few instances are still running on other threads
+        }
+    }
+
+private:
+    void workerLoop()
+    {
+        auto seenGeneration = generation.load();
+
+        while (!quit.load(std::memory_order_relaxed))
+        {
+            auto current = generation.load(std::memory_order_acquire);
+            if (current == seenGeneration)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            seenGeneration = current;
+            drain();
+        }
+    }
+
+    void drain()
+    {
+        const auto numInstances = totalInstances.load(std::memory_order_relaxed);
+
+        for (;;)
+        {
+            auto index = nextInstance.fetch_add(1, std::memory_order_relaxed);
+            if (index >= numInstances)
+                break;
+
+            processInstance(index);
+            remaining.fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+    std::function<void(int)> processInstance;
+    std::vector<std::thread> workers;
+
+    //each on its own cache line, the counters are hammered by every thread
+    alignas(64) std::atomic<uint64_t> generation {0};
+    alignas(64) std::atomic<int> nextInstance {0};
+    alignas(64) std::atomic<int> remaining {0};
+    alignas(64) std::atomic<int> totalInstances {0};
+    std::atomic<bool> quit {false};
+};
+
+struct Instance
+{
+    std::unique_ptr<Project11AudioProcessor> processor;
+    juce::AudioBuffer<float> input;
+    juce::AudioBuffer<float> buffer;
+    juce::MidiBuffer midi;
+};
+
+double ticksToMs(juce::int64 ticks)
+{
+    return juce::Time::highResolutionTicksToSeconds(ticks) * 1000.0;
+}
+
+//signed: the resident set can shrink between two samples, and a size_t difference would wrap
+double bytesBetween(size_t before, size_t after)
+{
+    return static_cast<double>(static_cast<juce::int64>(after) - static_cast<juce::int64>(before));
+}
+
+} //end anonymous namespace
+
+//==============================================================================
+
+size_t getResidentBytes()
+{
+   #if JUCE_LINUX
+    long totalPages = 0, residentPages = 0;
+    if (auto* statm = std::fopen("/proc/self/statm", "r"))
+    {
+        if (std::fscanf(statm, "%ld %ld", &totalPages, &residentPages) != 2)
+            residentPages = 0;
+
+        std::fclose(statm);
+    }
+    return static_cast<size_t>(residentPages) * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+   #elif JUCE_MAC
+    mach_task_basic_info info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) == KERN_SUCCESS)
+        return static_cast<size_t>(info.resident_size);
+    return 0;
+   #else
+    return 0;
+   #endif
+}
+
+ScanResult runScan(int numInstances)
+{
+    ScanResult result;
+    result.numInstances = juce::jmax(1, numInstances);
+    result.eagerInstantiation = PROJECT11_EAGER_INSTANTIATION != 0;
+
+    std::vector<std::unique_ptr<Project11AudioProcessor>> instances;
+    instances.reserve(static_cast<size_t>(result.numInstances));
+
+    auto bytesBefore = getResidentBytes();
+    auto startTicks = juce::Time::getHighResolutionTicks();
+
+    for (int i = 0; i < result.numInstances; ++i)
+    {
+        auto processor = std::make_unique<Project11AudioProcessor>();
+
+        //roughly what a scan asks for
+        for (auto* param : processor->getParameters())
+        {
+            juce::ignoreUnused(param->getName(64), param->getValue(), param->getText(param->getValue(), 64));
+        }
+
+        juce::MemoryBlock state;
+        processor->getStateInformation(state);
+
+        instances.push_back(std::move(processor));
+    }
+
+    result.msPerInstance = ticksToMs(juce::Time::getHighResolutionTicks() - startTicks) / result.numInstances;
+
+    if (bytesBefore > 0)
+        result.bytesPerInstance = bytesBetween(bytesBefore, getResidentBytes()) / result.numInstances;
+
+    return result;
+}
+
+RenderResult runRenderBenchmark(int width, int height, int numFrames)
+{
+    RenderResult result;
+    result.width = juce::jmax(1, width);
+    result.height = juce::jmax(1, height);
+    result.numFrames = juce::jmax(1, numFrames);
+
+    Project11AudioProcessor processor;
+    processor.setPlayConfigDetails(2, 2, 48000.0, 512);
+    processor.prepareToPlay(48000.0, 512);
+
+    ResponseCurveComponent component(processor);
+    component.setSize(result.width, result.height);
+
+    //the first frames pay for glyph caches and the like
+    component.renderFramesHeadless(8);
+
+    auto times = component.renderFramesHeadless(result.numFrames);
+    result.meanFrameMs = times.meanMs;
+    result.worstFrameMs = times.worstMs;
+
+    processor.releaseResources();
+    return result;
+}
+
+std::vector<CrossoverCost> runCrossoverBenchmark(double sampleRate, int blockSize, int numBlocks)
+{
+    blockSize = juce::jmax(1, blockSize);
+    numBlocks = juce::jmax(1, numBlocks);
+
+    juce::AudioBuffer<float> input(2, blockSize), buffer(2, blockSize);
+    juce::Random random(0x31);
+    for (int channel = 0; channel < 2; ++channel)
+        for (int i = 0; i < blockSize; ++i)
+            input.setSample(channel, i, random.nextFloat() * 0.5f - 0.25f);
+
+    juce::dsp::AudioBlock<float> block(buffer);
+
+    //fresh input every block, like run() does; the copy is a few hundred ns per block and is counted in both
+    auto timeBlocks = [&](auto&& process)
+    {
+        for (int i = 0; i < 16; ++i)
+        {
+            buffer.makeCopyOf(input, true);
+            process();
+        }
+
+        auto startTicks = juce::Time::getHighResolutionTicks();
+
+        for (int i = 0; i < numBlocks; ++i)
+        {
+            buffer.makeCopyOf(input, true);
+            process();
+        }
+
+        return ticksToMs(juce::Time::getHighResolutionTicks() - startTicks) * 1.0e6 / (static_cast<double>(numBlocks) * blockSize);
+    };
+
+    //the baseline: the processor's left and right Filterchain with one Peak in them
+    using Filterchain = juce::dsp::ProcessorChain<juce::dsp::IIR::Filter<float>>;
+    Filterchain leftChain, rightChain;
+
+    juce::dsp::ProcessSpec spec;
+    spec.sampleRate = sampleRate;
+    spec.maximumBlockSize = static_cast<juce::uint32>(blockSize);
+    spec.numChannels = 1;
+    leftChain.prepare(spec);
+    rightChain.prepare(spec);
+
+    auto peak = juce::dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate, 1000.f, 1.f, juce::Decibels::decibelsToGain(6.f));
+    *leftChain.get<0>().coefficients = *peak;
+    *rightChain.get<0>().coefficients = *peak;
+
+    auto leftBlock = block.getSingleChannelBlock(0);
+    auto rightBlock = block.getSingleChannelBlock(1);
+    juce::dsp::ProcessContextReplacing<float> leftContext(leftBlock), rightContext(rightBlock);
+
+    const auto filterchainNs = timeBlocks([&]
+    {
+        leftChain.process(leftContext);
+        rightChain.process(rightContext);
+    });
+
+    std::vector<CrossoverCost> results;
+
+    for (int numBands = Crossover::minBands; numBands <= Crossover::maxBands; ++numBands)
+    {
+        Crossover crossover;
+        crossover.prepare(sampleRate, 2);
+
+        //splits spread evenly in log frequency between 100Hz and 10kHz
+        std::array<float, Crossover::maxBands - 1> frequencies {};
+        for (int i = 0; i < numBands - 1; ++i)
+            frequencies[static_cast<size_t>(i)] = 100.f * std::pow(100.f, static_cast<float>(i + 1) / static_cast<float>(numBands));
+
+        std::array<float, Crossover::maxBands> gains;
+        gains.fill(1.f);
+
+        crossover.setCrossovers(numBands, frequencies.data());
+        crossover.setBandGains(gains.data());
+
+        CrossoverCost cost;
+        cost.numBands = numBands;
+        cost.nsPerSample = timeBlocks([&] { crossover.process(block); });
+        cost.nsPerBand = cost.nsPerSample / numBands;
+        cost.filterchainNsPerSample = filterchainNs;
+        cost.ratio = filterchainNs > 0.0 ? cost.nsPerSample / filterchainNs : 0.0;
+        results.push_back(cost);
+    }
+
+    return results;
+}
+
+std::vector<DynamicBandCost> runDynamicBandBenchmark(double sampleRate, int blockSize, int numBlocks)
+{
+    blockSize = juce::jmax(1, blockSize);
+    numBlocks = juce::jmax(1, numBlocks);
+
+    juce::AudioBuffer<float> input(2, blockSize), buffer(2, blockSize);
+    juce::Random random(0x32);
+    for (int channel = 0; channel < 2; ++channel)
+        for (int i = 0; i < blockSize; ++i)
+            input.setSample(channel, i, random.nextFloat() * 0.5f - 0.25f);
+
+    juce::dsp::AudioBlock<float> block(buffer);
+    const juce::dsp::AudioBlock<float> detector(input);
+
+    //times numBlocks of processBlock after a short warm up, fresh input every block
+    auto timeBlocks = [&](auto&& processBlock)
+    {
+        for (int i = 0; i < 16; ++i)
+        {
+            buffer.makeCopyOf(input, true);
+            processBlock();
+        }
+
+        auto startTicks = juce::Time::getHighResolutionTicks();
+
+        for (int i = 0; i < numBlocks; ++i)
+        {
+            buffer.makeCopyOf(input, true);
+            processBlock();
+        }
+
+        return ticksToMs(juce::Time::getHighResolutionTicks() - startTicks) * 1.0e6 / (static_cast<double>(numBlocks) * blockSize);
+    };
+
+    DynamicBand::Settings settings;
+    settings.shape = DynamicBand::Peak;
+    settings.frequency = 1000.f;
+    settings.quality = 1.f;
+    settings.gainInDecibels = 0.f;
+    settings.thresholdInDecibels = -40.f;
+    settings.ratio = 4.f;
+    settings.attackMs = 1.f;
+    settings.releaseMs = 50.f;
+
+    //the static band: the same Peak at -6dB, designed once
+    CascadeFilter staticBand;
+    staticBand.prepare(2);
+    {
+        auto coefficients = juce::dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate, settings.frequency, settings.quality,
+                                                                                 juce::Decibels::decibelsToGain(-6.f));
+        const auto* c = coefficients->getRawCoefficients();
+
+        SlopeDesign::Sections sections;
+        sections.numSections = 1;
+        sections.sections[0] = { c[0], c[1], c[2], c[3], c[4] };
+        staticBand.setSections(sections);
+    }
+
+    const auto staticNs = timeBlocks([&] { staticBand.process(block); });
+
+    std::vector<DynamicBandCost> results;
+
+    for (auto subBlockSize : { DynamicBand::defaultSubBlockSize, 128 })
+    {
+        DynamicBand band;
+        band.setSubBlockSize(subBlockSize);
+        band.prepare(sampleRate, 2);
+        band.setSettings(settings);
+
+        DynamicBandCost cost;
+        cost.subBlockSize = subBlockSize;
+        cost.staticNsPerSample = staticNs;
+        cost.dynamicNsPerSample = timeBlocks([&] { band.process(block, detector); });
+        cost.ratio = staticNs > 0.0 ? cost.dynamicNsPerSample / staticNs : 0.0;
+
+        std::array<DynamicBand, DynamicBandCost::budgetBands> bands;
+        for (size_t i = 0; i < bands.size(); ++i)
+        {
+            auto bandSettings = settings;
+            bandSettings.frequency = 100.f * std::pow(100.f, static_cast<float>(i) / static_cast<float>(bands.size() - 1));
+
+            bands[i].setSubBlockSize(subBlockSize);
+            bands[i].prepare(sampleRate, 2);
+            bands[i].setSettings(bandSettings);
+        }
+
+        //each band listens to the dry input, so all of them keep compressing however much the ones before took out
+        cost.budgetBandsNsPerSample = timeBlocks([&]
+        {
+            for (auto& band : bands)
+                band.process(block, detector);
+        });
+
+        cost.percentOfRealTime = cost.budgetBandsNsPerSample * sampleRate * 1.0e-7;
+        cost.withinBudget = cost.percentOfRealTime <= DynamicBandCost::budgetPercent;
+
+        results.push_back(cost);
+    }
+
+    return results;
+}
+
+MatchRun runMatch(const juce::File& reference, const juce::File& mix, int numThreads)
+{
+    MatchRun run;
+    run.numThreads = numThreads > 0 ? numThreads : juce::jlimit(1, 32, juce::SystemStats::getNumCpus());
+
+    juce::AudioFormatManager formats;
+    formats.registerBasicFormats();
+
+    auto getSeconds = [&formats](const juce::File& file)
+    {
+        std::unique_ptr<juce::AudioFormatReader> reader { formats.createReaderFor(file) };
+        return reader != nullptr && reader->sampleRate > 0.0 ? static_cast<double>(reader->lengthInSamples) / reader->sampleRate : 0.0;
+    };
+
+    run.referenceSeconds = getSeconds(reference);
+    run.mixSeconds = getSeconds(mix);
+
+    const auto result = MatchEQ::analyseAndFit(reference, mix, run.numThreads);
+    run.ok = result.ok;
+    run.error = result.error;
+    run.type = FilterInfo::filterToString(result.type);
+    run.frequency = result.frequency;
+    run.quality = result.quality;
+    run.gainInDecibels = result.gainInDecibels;
+    run.residualDb = result.residualDb;
+    run.analysisSeconds = result.analysisSeconds;
+    return run;
+}
+
+bool writeMatchPair(const juce::File& reference, const juce::File& mix, double minutes, juce::String& error)
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int numChannels = 2;
+    constexpr int chunkSize = 1 << 16;
+
+    juce::WavAudioFormat wav;
+    std::array<std::unique_ptr<juce::AudioFormatWriter>, 2> writers;
+    std::array<juce::File, 2> files { reference, mix };
+
+    for (size_t i = 0; i < writers.size(); ++i)
+    {
+        files[i].deleteFile();
+        auto stream = files[i].createOutputStream();
+
+        if (stream != nullptr)
+            writers[i].reset(wav.createWriterFor(stream.get(), sampleRate, numChannels, 24, {}, 0));
+
+        if (writers[i] == nullptr)
+        {
+            error = "Couldn't write " + files[i].getFullPathName();
+            return false;
+        }
+
+        //the writer owns it now
+        stream.release();
+    }
+
+    //the reference is the mix through the band the fit should find
+    auto coefficients = makeCoefficients(FilterInfo::Peak, 2000.f, 1.f, 6.f, static_cast<float>(sampleRate));
+    std::array<juce::dsp::IIR::Filter<float>, numChannels> filters;
+    for (auto& filter : filters)
+        filter.coefficients = coefficients;
+
+    juce::AudioBuffer<float> mixChunk(numChannels, chunkSize), referenceChunk(numChannels, chunkSize);
+    juce::Random random(0x36);
+
+    auto remaining = static_cast<juce::int64>(minutes * 60.0 * sampleRate);
+    while (remaining > 0)
+    {
+        const auto numSamples = static_cast<int>(juce::jmin(static_cast<juce::int64>(chunkSize), remaining));
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            for (int i = 0; i < numSamples; ++i)
+                mixChunk.setSample(channel, i, random.nextFloat() * 0.5f - 0.25f);
+
+        referenceChunk.makeCopyOf(mixChunk, true);
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            auto* samples = referenceChunk.getWritePointer(channel);
+            for (int i = 0; i < numSamples; ++i)
+                samples[i] = filters[static_cast<size_t>(channel)].processSample(samples[i]);
+        }
+
+        if (! writers[0]->writeFromAudioSampleBuffer(referenceChunk, 0, numSamples)
+            || ! writers[1]->writeFromAudioSampleBuffer(mixChunk, 0, numSamples))
+        {
+            error = "Couldn't write the match pair";
+            return false;
+        }
+
+        remaining -= numSamples;
+    }
+
+    return true;
+}
+
+Result run(const Config& config)
+{
+    Result result;
+    result.numInstances = juce::jmax(1, config.numInstances);
+    result.numThreads = config.numThreads > 0 ? config.numThreads
+                                              : juce::jmax(1, juce::SystemStats::getNumCpus());
+    result.deadlineMs = 1000.0 * config.blockSize / config.sampleRate;
+
+    std::vector<Instance> instances(static_cast<size_t>(result.numInstances));
+
+    //construction, the part a host scan pays for
+    auto bytesBefore = getResidentBytes();
+    auto startTicks = juce::Time::getHighResolutionTicks();
+
+    for (auto& instance : instances)
+    {
+        instance.processor = std::make_unique<Project11AudioProcessor>();
+    }
+
+    result.constructionMsPerInstance = ticksToMs(juce::Time::getHighResolutionTicks() - startTicks) / result.numInstances;
+    auto bytesConstructed = getResidentBytes();
+
+    //preparation, the part a project load pays for on top
+    startTicks = juce::Time::getHighResolutionTicks();
+    juce::Random random(0x11);
+
+    for (auto& instance : instances)
+    {
+        instance.processor->setPlayConfigDetails(2, 2, config.sampleRate, config.blockSize);
+        instance.processor->prepareToPlay(config.sampleRate, config.blockSize);
+
+        instance.input.setSize(2, config.blockSize);
+        instance.buffer.setSize(2, config.blockSize);
+        for (int channel = 0; channel < 2; ++channel)
+            for (int i = 0; i < config.blockSize; ++i)
+                instance.input.setSample(channel, i, random.nextFloat() * 0.5f - 0.25f);
+    }
+
+    result.prepareMsPerInstance = ticksToMs(juce::Time::getHighResolutionTicks() - startTicks) / result.numInstances;
+    auto bytesPrepared = getResidentBytes();
+
+    if (bytesBefore > 0)
+    {
+        result.constructedBytesPerInstance = bytesBetween(bytesBefore, bytesConstructed) / result.numInstances;
+        result.preparedBytesPerInstance = bytesBetween(bytesBefore, bytesPrepared) / result.numInstances;
+    }
+
+    //processing
+    {
+        WorkerPool pool(result.numThreads, [&instances](int index)
+        {
+            auto& instance = instances[static_cast<size_t>(index)];
+
+            //fresh input every block, feeding the output back in would end up measuring denormals or infs
+            instance.buffer.makeCopyOf(instance.input, true);
+            instance.processor->processBlock(instance.buffer, instance.midi);
+        });
+
+        //a few callbacks to get caches, branch predictors and the parameter smoothing settled
+        for (int i = 0; i < 16; ++i)
+            pool.runCallback(result.numInstances);
+
+        int numMisses = 0;
+        juce::int64 worstTicks = 0;
+        auto runStart = juce::Time::getHighResolutionTicks();
+
+        for (int callback = 0; callback < config.numCallbacks; ++callback)
+        {
+            auto callbackStart = juce::Time::getHighResolutionTicks();
+            pool.runCallback(result.numInstances);
+            auto elapsed = juce::Time::getHighResolutionTicks() - callbackStart;
+
+            worstTicks = juce::jmax(worstTicks, elapsed);
+            if (ticksToMs(elapsed) > result.deadlineMs)
+                ++numMisses;
+        }
+
+        auto totalMs = ticksToMs(juce::Time::getHighResolutionTicks() - runStart);
+        auto numCallbacks = juce::jmax(1, config.numCallbacks);
+
+        result.meanCallbackMs = totalMs / numCallbacks;
+        result.worstCallbackMs = ticksToMs(worstTicks);
+        result.deadlineMissRate = static_cast<double>(numMisses) / numCallbacks;
+        result.throughput = totalMs > 0.0 ? 1000.0 * numCallbacks * result.numInstances / totalMs : 0.0;
+    }
+
+    for (auto& instance : instances)
+    {
+        instance.processor->releaseResources();
+    }
+
+    return result;
+}
+
+std::vector<Result> runScalingSweep(const Config& config, std::function<void(const Result&)> onResult)
+{
+    const auto maxThreads = config.numThreads > 0 ? config.numThreads
+                                                  : juce::jmax(1, juce::SystemStats::getNumCpus());
+
+    std::vector<int> threadCounts;
+    for (int threads = 1; threads < maxThreads; threads *= 2)
+        threadCounts.push_back(threads);
+    threadCounts.push_back(maxThreads);
+
+    std::vector<Result> results;
+    double singleThreadThroughput = 0.0;
+
+    for (auto threads : threadCounts)
+    {
+        auto threadConfig = config;
+        threadConfig.numThreads = threads;
+
+        auto result = run(threadConfig);
+
+        if (threads == 1)
+            singleThreadThroughput = result.throughput;
+
+        if (singleThreadThroughput > 0.0)
+            result.scalingEfficiency = result.throughput / (threads * singleThreadThroughput);
+
+        if (onResult != nullptr)
+            onResult(result);
+
+        results.push_back(result);
+    }
+
+    return results;
+}
+
+juce::String toString(const Result& result)
+{
+    juce::String s;
+    s << "instances: " << result.numInstances
+      << "  threads: " << result.numThreads
+      << "  construct: " << juce::String(result.constructionMsPerInstance, 3) << " ms/inst"
+      << "  prepare: " << juce::String(result.prepareMsPerInstance, 3) << " ms/inst"
+      << "  memory: " << juce::String(result.constructedBytesPerInstance / 1024.0, 1) << " KiB constructed, "
+                      << juce::String(result.preparedBytesPerInstance / 1024.0, 1) << " KiB prepared"
+      << "  throughput: " << juce::String(result.throughput, 0) << " blocks/s"
+      << "  callback: " << juce::String(result.meanCallbackMs, 3) << " ms mean, "
+                        << juce::String(result.worstCallbackMs, 3) << " ms worst (deadline "
+                        << juce::String(result.deadlineMs, 3) << " ms)"
+      << "  misses: " << juce::String(result.deadlineMissRate * 100.0, 2) << "%"
+      << "  scaling: " << juce::String(result.scalingEfficiency * 100.0, 1) << "%";
+    return s;
+}
+
+juce::String toString(const ScanResult& result)
+{
+    juce::String s;
+    s << (result.eagerInstantiation ? "scan (eager build) of " : "scan of ") << result.numInstances << " instances: "
+      << juce::String(result.msPerInstance, 3) << " ms/inst, "
+      << juce::String(result.bytesPerInstance / 1024.0, 1) << " KiB/inst";
+    return s;
+}
+
+juce::String toString(const RenderResult& result)
+{
+    juce::String s;
+    s << result.numFrames << " frames at " << result.width << "x" << result.height << ": "
+      << juce::String(result.meanFrameMs, 3) << " ms mean, " << juce::String(result.worstFrameMs, 3) << " ms worst";
+    return s;
+}
+
+juce::String toString(const CrossoverCost& result)
+{
+    juce::String s;
+    s << result.numBands << " bands: " << juce::String(result.nsPerSample, 1) << " ns per stereo sample, "
+      << juce::String(result.nsPerBand, 1) << " ns per band, " << juce::String(result.ratio, 2) << "x the Filterchain ("
+      << juce::String(result.filterchainNsPerSample, 1) << " ns)";
+    return s;
+}
+
+juce::String toString(const DynamicBandCost& result)
+{
+    juce::String s;
+    s << "dynamic band, sub-block " << result.subBlockSize << ": " << juce::String(result.dynamicNsPerSample, 1)
+      << " ns per stereo sample, static band " << juce::String(result.staticNsPerSample, 1) << " ns, "
+      << juce::String(result.ratio, 2) << "x | " << DynamicBandCost::budgetBands << " bands " << juce::String(result.budgetBandsNsPerSample, 1)
+      << " ns, " << juce::String(result.percentOfRealTime, 2) << "% of real time, "
+      << (result.withinBudget ? "within " : "over ") << juce::String(DynamicBandCost::budgetPercent, 1) << "% budget";
+    return s;
+}
+
+juce::String toString(const MatchRun& result)
+{
+    juce::String s;
+    s << "match of " << juce::String(result.referenceSeconds / 60.0, 1) << " min reference, " << juce::String(result.mixSeconds / 60.0, 1)
+      << " min mix on " << result.numThreads << " threads: " << juce::String(result.analysisSeconds, 2) << " s | ";
+
+    if (result.ok)
+        s << result.type << " " << juce::String(result.frequency, 0) << " Hz, Q " << juce::String(result.quality, 1) << ", "
+          << juce::String(result.gainInDecibels, 1) << " dB, residual " << juce::String(result.residualDb, 2) << " dB";
+    else
+        s << "failed: " << result.error;
+
+    return s;
+}
+
+//==============================================================================
+
+DesignTest testDesigns()
+{
+    using namespace FilterInfo;
+
+    DesignTest result;
+    result.worstExcessOverBilinearDb = -std::numeric_limits<double>::max();
+
+    std::vector<float> frequencies;
+    for (int i = 0; i < 30; ++i)
+        frequencies.push_back(20.f * std::pow(2.f, static_cast<float>(i) / 3.f));
+    frequencies.push_back(20000.f);
+
+    //the parameters' own steps, see createParameterLayout()
+    std::vector<float> qualities, gains;
+    for (int i = 0; i < 20; ++i)
+        qualities.push_back(0.1f + 0.5f * static_cast<float>(i));
+    for (int i = -24; i <= 24; ++i)
+        gains.push_back(static_cast<float>(i));
+
+    juce::int64 pickTicks = 0, bilinearTicks = 0, matchedTicks = 0;
+
+    for (auto sampleRate : { 44100.0, 48000.0, 96000.0 })
+    {
+        const auto sr = static_cast<float>(sampleRate);
+
+        for (auto [type, shape] : { std::pair { Peak, MatchedDesign::Peak },
+                                    std::pair { LowShelf, MatchedDesign::LowShelf },
+                                    std::pair { HighShelf, MatchedDesign::HighShelf } })
+        {
+            auto& worstErrorsDb = type == Peak ? result.worstPeakErrorDb : result.worstShelfErrorDb;
+            const auto& tolerancesDb = type == Peak ? DesignTest::peakToleranceDb : DesignTest::shelfToleranceDb;
+
+            for (auto freq : frequencies)
+            {
+                for (auto q : qualities)
+                {
+                    const auto qRange = static_cast<size_t>(DesignTest::getQRange(q));
+
+                    for (auto gainDb : gains)
+                    {
+                        auto startTicks = juce::Time::getHighResolutionTicks();
+                        auto bilinear = makeCoefficients(type, freq, q, gainDb, sr, false);
+                        bilinearTicks += juce::Time::getHighResolutionTicks() - startTicks;
+
+                        //the pick runs on the MethodPicker's thread, the design on the audio thread
+                        startTicks = juce::Time::getHighResolutionTicks();
+                        const auto method = MatchedDesign::pickMethod(shape, freq, q, gainDb, sampleRate);
+                        pickTicks += juce::Time::getHighResolutionTicks() - startTicks;
+
+                        startTicks = juce::Time::getHighResolutionTicks();
+                        auto matched = makeCoefficients(type, freq, q, gainDb, sr, true, method);
+                        matchedTicks += juce::Time::getHighResolutionTicks() - startTicks;
+
+                        //worst |dB| off the prototype, over the whole range and above sr/4
+                        double bilinearError = 0.0, matchedError = 0.0;
+                        double bilinearHighError = 0.0, matchedHighError = 0.0;
+
+                        for (double f = 20.0; f < sampleRate * 0.5; f *= std::pow(2.0, 1.0 / 48.0))
+                        {
+                            const auto target = juce::Decibels::gainToDecibels(MatchedDesign::getAnalogMagnitude(shape, freq, q, gainDb, f), -200.0);
+                            const auto matchedOff = std::abs(juce::Decibels::gainToDecibels(matched->getMagnitudeForFrequency(f, sampleRate), -200.0) - target);
+                            const auto bilinearOff = std::abs(juce::Decibels::gainToDecibels(bilinear->getMagnitudeForFrequency(f, sampleRate), -200.0) - target);
+
+                            bilinearError = juce::jmax(bilinearError, bilinearOff);
+                            matchedError = juce::jmax(matchedError, matchedOff);
+
+                            if (f >= sampleRate * 0.25)
+                            {
+                                bilinearHighError = juce::jmax(bilinearHighError, bilinearOff);
+                                matchedHighError = juce::jmax(matchedHighError, matchedOff);
+                            }
+                        }
+
+                        ++result.numDesigns;
+                        worstErrorsDb[qRange] = juce::jmax(worstErrorsDb[qRange], matchedHighError);
+                        result.worstExcessOverBilinearDb = juce::jmax(result.worstExcessOverBilinearDb, matchedError - bilinearError);
+
+                        const auto isBilinearOff = bilinearHighError > DesignTest::bilinearOffDb;
+                        const auto remainingShare = isBilinearOff ? matchedHighError / bilinearHighError : 0.0;
+                        if (isBilinearOff)
+                        {
+                            ++result.numBilinearOff;
+                            result.worstRemainingShare = juce::jmax(result.worstRemainingShare, remainingShare);
+                        }
+
+                        juce::String failure;
+                        if (matchedHighError > tolerancesDb[qRange])
+                            failure << "more than " << juce::String(tolerancesDb[qRange], 1) << " dB off above sr/4";
+                        else if (isBilinearOff && remainingShare > 1.0 - DesignTest::requiredImprovement)
+                            failure << "keeps " << juce::roundToInt(remainingShare * 100.0) << "% of bilinear's "
+                                    << juce::String(bilinearHighError, 2) << " dB above sr/4";
+                        else if (matchedError > bilinearError + DesignTest::bilinearSlackDb)
+                            failure << "worse than bilinear (" << juce::String(bilinearError, 2) << " dB)";
+
+                        if (failure.isNotEmpty() && ++result.numFailures <= 20)
+                        {
+                            juce::String line;
+                            line << filterToString(type) << " " << juce::String(freq, 0) << " Hz, Q " << juce::String(q, 1) << ", "
+                                 << juce::String(gainDb, 0) << " dB at " << juce::String(sampleRate, 0) << ": matched "
+                                 << juce::String(matchedHighError, 2) << " dB above sr/4, " << failure;
+                            result.failures.add(line);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    result.pickNsPerDesign = ticksToMs(pickTicks) * 1.0e6 / juce::jmax(1, result.numDesigns);
+    result.bilinearNsPerDesign = ticksToMs(bilinearTicks) * 1.0e6 / juce::jmax(1, result.numDesigns);
+    result.matchedNsPerDesign = ticksToMs(matchedTicks) * 1.0e6 / juce::jmax(1, result.numDesigns);
+
+    return result;
+}
+
+juce::String toString(const DesignTest& result)
+{
+    const char* rangeNames[DesignTest::numQRanges] { "Q < 1", "Q 1-3", "Q 3-6", "Q >= 6" };
+
+    juce::String s;
+    s << result.numDesigns << " peak/shelf designs, worst |dB| off the prototype above sr/4 (limit):";
+
+    for (size_t range = 0; range < static_cast<size_t>(DesignTest::numQRanges); ++range)
+    {
+        s << "\n    " << rangeNames[range] << ": peak " << juce::String(result.worstPeakErrorDb[range], 2) << " ("
+          << juce::String(DesignTest::peakToleranceDb[range], 1) << "), shelves " << juce::String(result.worstShelfErrorDb[range], 2)
+          << " (" << juce::String(DesignTest::shelfToleranceDb[range], 1) << ")";
+    }
+
+    s << "\nbilinear more than " << juce::String(DesignTest::bilinearOffDb, 1) << " dB off above sr/4 in " << result.numBilinearOff
+      << " designs, matched keeps at most " << juce::roundToInt(result.worstRemainingShare * 100.0) << "% of that (limit "
+      << juce::roundToInt((1.0 - DesignTest::requiredImprovement) * 100.0) << "%)"
+      << "\nat most " << juce::String(result.worstExcessOverBilinearDb, 3) << " dB worse than bilinear anywhere"
+      << "\npick " << juce::String(result.pickNsPerDesign, 0) << " ns, matched design " << juce::String(result.matchedNsPerDesign, 0)
+      << " ns, bilinear " << juce::String(result.bilinearNsPerDesign, 0) << " ns | " << result.numFailures << " failed";
+
+    for (const auto& failure : result.failures)
+        s << "\n    " << failure;
+
+    return s;
+}
+
+} //end namespace HostSimulation
@@ -0,0 +1,226 @@
+/*
+  ==============================================================================
+
+    HostSimulation.h
+    Created: 18 Oct 2026 2:40:05pm
+    Author:  Marc Woodbury-Smith
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <functional>
+
+/*Headless multi-instance load test.
+
+ Builds N Project11AudioProcessor instances and runs them the way a DAW runs a flat graph of parallel tracks: every audio
+ callback, a pool of worker threads (the calling thread included) grabs instances off a shared counter until all N have
+ processed one block, and the callback is late if that took longer than the block lasts in real time.
+ This is what a single instance microbenchmark can't show: cache thrash between instances, false sharing, and what
+ construction and per-instance state cost once there are hundreds of them.
+
+ HostSimulation.cpp is not part of the plugin target. HostSimulation/HostSimulation.jucer builds it with the plugin
+ sources into a console app (HostSimulation --help for the commands); anything else calling in needs a
+ juce::ScopedJuceInitialiser_GUI first (apvts wants a message manager) and has to call from the message thread.*/
+namespace HostSimulation
+{
+
+struct Config
+{
+    int numInstances {100};
+    int numThreads {0};         // 0 == all cores
+    double sampleRate {48000.0};
+    int blockSize {128};
+    int numCallbacks {2000};
+};
+
+struct Result
+{
+    int numInstances {0};
+    int numThreads {0};
+
+    //construction and preparation measured separately, a host scan only ever pays for the first
+    double constructionMsPerInstance {0.0};
+    double prepareMsPerInstance {0.0};
+    double constructedBytesPerInstance {0.0};
+    double preparedBytesPerInstance {0.0};
+
+    //instance-blocks processed per wall clock second
+    double throughput {0.0};
+    //fraction of callbacks that took longer than blockSize / sampleRate
+    double deadlineMissRate {0.0};
+    double meanCallbackMs {0.0};
+    double worstCallbackMs {0.0};
+    double deadlineMs {0.0};
+
+    //throughput / (numThreads * single thread throughput), filled in by runScalingSweep()
+    double scalingEfficiency {1.0};
+};
+
+/*What a host plugin scan or a project load does before any audio runs: construct, read every parameter, save state.
+ Nothing is prepared. The before of the constexpr tables and lazy DSP state is a separate build with
+ PROJECT11_EAGER_INSTANTIATION=1 (HostSimulation.jucer's ReleaseEager configuration): run this in both builds and
+ compare. eagerInstantiation says which build this is.*/
+struct ScanResult
+{
+    int numInstances {0};
+    bool eagerInstantiation {false};
+    double msPerInstance {0.0};
+    double bytesPerInstance {0.0};
+};
+
+ScanResult runScan(int numInstances);
+
+/*The editor's display (ResponseCurveComponent) painted offscreen at width x height, with the response curve and the
+ analyzer path both rebuilt every frame: the worst a display frame can cost, without a window or a display.*/
+struct RenderResult
+{
+    int width {0};
+    int height {0};
+    int numFrames {0};
+    double meanFrameMs {0.0};
+    double worstFrameMs {0.0};
+};
+
+RenderResult runRenderBenchmark(int width, int height, int numFrames);
+
+/*What the crossover (Crossover.h) costs at each band count, processing stereo noise with every band at unity.
+ ns per stereo sample frame, that divided by the number of bands, and the baseline: the plugin's own L/R Filterchain
+ pair (one Peak at 1kHz) timed over the same input, with the crossover's cost as a multiple of it.*/
+struct CrossoverCost
+{
+    int numBands {0};
+    double nsPerSample {0.0};
+    double nsPerBand {0.0};
+    double filterchainNsPerSample {0.0};
+    double ratio {0.0};
+};
+
+std::vector<CrossoverCost> runCrossoverBenchmark(double sampleRate, int blockSize, int numBlocks);
+
+/*What a dynamic band (DynamicBand.h) costs against a static one: a Peak at 1kHz on stereo noise, the static band as
+ one biquad in a CascadeFilter, the dynamic one compressing hard (-40dB threshold, 4:1, 1ms attack) so every sub-block
+ redesigns and ramps. ns per stereo sample frame for each, and dynamic over static.
+
+ Then the budget the dynamic bands were built to: budgetBands of them in series on stereo, spread from 100Hz to 10kHz
+ and all compressing, must take no more than budgetPercent of one core in real time at the sample rate (at 48kHz, 417ns
+ per stereo sample frame).*/
+struct DynamicBandCost
+{
+    static constexpr int budgetBands = 8;
+    static constexpr double budgetPercent = 2.0;
+
+    int subBlockSize {0};
+    double staticNsPerSample {0.0};
+    double dynamicNsPerSample {0.0};
+    double ratio {0.0};
+
+    double budgetBandsNsPerSample {0.0};
+    double percentOfRealTime {0.0};
+    bool withinBudget {false};
+};
+
+std::vector<DynamicBandCost> runDynamicBandBenchmark(double sampleRate, int blockSize, int numBlocks);
+
+/*MatchEQ's analysis and fit (MatchEQ::analyseAndFit()) on a reference and a mix, timed as the Match button runs them.
+ writeMatchPair() makes a pair to run it on: minutes of 48kHz stereo noise as the mix, and the same noise through a
+ +6dB Peak at 2kHz, Q 1, as the reference, so the fit should land on that band.*/
+struct MatchRun
+{
+    int numThreads {0};
+    double referenceSeconds {0.0};
+    double mixSeconds {0.0};
+
+    bool ok {false};
+    juce::String error;
+    juce::String type;
+    float frequency {0.f};
+    float quality {0.f};
+    float gainInDecibels {0.f};
+    float residualDb {0.f};
+
+    double analysisSeconds {0.0};
+};
+
+MatchRun runMatch(const juce::File& reference, const juce::File& mix, int numThreads);
+bool writeMatchPair(const juce::File& reference, const juce::File& mix, double minutes, juce::String& error);
+
+/*A test of the analog matched design (MatchedDesign.h), as the band runs it through makeCoefficients() with the method
+ MatchedDesign::pickMethod() chooses, over everything the parameters allow: 44.1, 48 and 96kHz, 1/3 octave from 20Hz to
+ 20kHz, every Q step, every 1dB gain step, Peak and both shelves. Magnitudes come from getMagnitudeForFrequency() in
+ 1/48 octave steps, so they don't share a grid with the one MatchedDesign picks on.
+
+ Above a quarter of the sample rate is where the bilinear design cramps and where matching has to earn its keep, so
+ that's where it's checked hardest. A design fails if
+     - above sr/4, it's further off the analog prototype than the tolerance for its shape and Q range (qRangeEnds).
+       A biquad can only follow a wide peak or the bump of a high Q shelf so far towards Nyquist, so the wide peaks and
+       the high Q shelves get more room.
+     - above sr/4, bilinear is more than bilinearOffDb off and the matched design doesn't take at least
+       requiredImprovement of that error away
+     - anywhere from 20Hz to Nyquist, it's worse than bilinear by more than bilinearSlackDb (the pick is made on
+       MatchedDesign's coarser grid)
+ The tolerances are regression limits: what the designs reach now, rounded up to the next half dB. Also reports what a
+ pick and a design cost.*/
+struct DesignTest
+{
+    static constexpr int numQRanges = 4;
+    //upper end of every Q range but the last
+    static constexpr std::array<float, numQRanges - 1> qRangeEnds { 1.f, 3.f, 6.f };
+    static constexpr std::array<double, numQRanges> peakToleranceDb { 4.0, 4.0, 3.5, 2.5 };
+    static constexpr std::array<double, numQRanges> shelfToleranceDb { 3.0, 3.5, 7.5, 9.0 };
+
+    static constexpr double bilinearOffDb = 1.0;
+    static constexpr double requiredImprovement = 0.25;
+    static constexpr double bilinearSlackDb = 0.05;
+
+    static int getQRange(float q) noexcept
+    {
+        int range = 0;
+        while (range < numQRanges - 1 && q >= qRangeEnds[static_cast<size_t>(range)])
+            ++range;
+        return range;
+    }
+
+    int numDesigns {0};
+
+    double pickNsPerDesign {0.0};
+    double bilinearNsPerDesign {0.0};
+    double matchedNsPerDesign {0.0};
+
+    //worst |dB| off the prototype above sr/4, per Q range
+    std::array<double, numQRanges> worstPeakErrorDb {};
+    std::array<double, numQRanges> worstShelfErrorDb {};
+
+    //designs where bilinear is more than bilinearOffDb off above sr/4, and the largest share of that error left over
+    int numBilinearOff {0};
+    double worstRemainingShare {0.0};
+
+    //how far the matched design is worse than bilinear from 20Hz to Nyquist, at its worst. Negative: better everywhere.
+    double worstExcessOverBilinearDb {0.0};
+
+    int numFailures {0};
+    //the first few, one line each
+    juce::StringArray failures;
+};
+
+DesignTest testDesigns();
+
+/*Runs one configuration. Construction and preparation happen on the calling thread, processing on the pool.*/
+Result run(const Config& config);
+
+/*Runs config at 1, 2, 4 ... threads up to config.numThreads (or all cores), reporting each result as it comes in.*/
+std::vector<Result> runScalingSweep(const Config& config, std::function<void(const Result&)> onResult = nullptr);
+
+juce::String toString(const Result& result);
+juce::String toString(const ScanResult& result);
+juce::String toString(const RenderResult& result);
+juce::String toString(const CrossoverCost& result);
+juce::String toString(const DynamicBandCost& result);
+juce::String toString(const MatchRun& result);
+juce::String toString(const DesignTest& result);
+
+//resident set size of this process, 0 where the platform doesn't tell us
+size_t getResidentBytes();
+
+} //end namespace HostSimulation
@@ -0,0 +1,440 @@
+/*
+  ==============================================================================
+
+    MatchEQ.cpp
+    Created: 20 Oct 2026 10:03:51am
+    Author:  Marc Woodbury-Smith
+
+  ==============================================================================
+*/
+
+#include "MatchEQ.h"
+#include "Trace.h"
+#include <thread>
+
+namespace
+{
+
+static constexpr int fftOrder = 12;
+static constexpr int fftSize = 1 << fftOrder;
+static constexpr int hopSize = fftSize / 2;
+static constexpr int numBins = fftSize / 2 + 1;
+//frames read per reader call
+static constexpr int framesPerChunk = 64;
+
+//fit grid: 1/12 octave, 20Hz to 20kHz, each point the mean power over 1/3 octave around it
+static constexpr double gridLowest = 20.0;
+static constexpr int pointsPerOctave = 12;
+static constexpr int numGridPoints = 10 * pointsPerOctave;
+//anything this far under the loudest point of either spectrum is noise floor and doesn't count
+static constexpr double floorDb = 80.0;
+
+std::unique_ptr<juce::AudioFormatReader> createReader(juce::AudioFormatManager& formats, const juce::File& file)
+{
+    //memory mapped where the format supports it, so the workers read straight out of the page cache
+    for (int i = 0; i < formats.getNumKnownFormats(); ++i)
+    {
+        auto* format = formats.getKnownFormat(i);
+        if (! format->canHandleFile(file))
+            continue;
+
+        if (std::unique_ptr<juce::MemoryMappedAudioFormatReader> mapped { format->createMemoryMappedReader(file) })
+        {
+            if (mapped->mapEntireFile())
+                return mapped;
+        }
+    }
+
+    return std::unique_ptr<juce::AudioFormatReader>(formats.createReaderFor(file));
+}
+
+//power spectrum summed over frames [firstFrame, endFrame), added into power
+void analyseFrames(juce::AudioFormatReader& reader, juce::int64 firstFrame, juce::int64 endFrame, std::vector<float>& power,
+                   const juce::Thread* threadToCheck)
+{
+    juce::dsp::FFT fft(fftOrder);
+
+    std::vector<float> window(fftSize);
+    juce::dsp::WindowingFunction<float>::fillWindowingTables(window.data(), fftSize,
+                                                             juce::dsp::WindowingFunction<float>::hann, false);
+
+    std::vector<float> fftData(2 * fftSize);
+
+    const auto numChannels = juce::jlimit(1, 2, static_cast<int>(reader.numChannels));
+    juce::AudioBuffer<float> chunk(numChannels, (framesPerChunk - 1) * hopSize + fftSize);
+
+    for (auto frame = firstFrame; frame < endFrame; frame += framesPerChunk)
+    {
+        if (threadToCheck != nullptr && threadToCheck->threadShouldExit())
+            return;
+
+        const auto numFrames = static_cast<int>(juce::jmin<juce::int64>(framesPerChunk, endFrame - frame));
+        const auto numSamples = (numFrames - 1) * hopSize + fftSize;
+
+        //past the end of the file reads as silence
+        reader.read(&chunk, 0, numSamples, frame * hopSize, true, numChannels > 1);
+
+        auto* mono = chunk.getWritePointer(0);
+        if (numChannels > 1)
+            juce::FloatVectorOperations::add(mono, chunk.getReadPointer(1), numSamples);
+
+        for (int f = 0; f < numFrames; ++f)
+        {
+            juce::FloatVectorOperations::multiply(fftData.data(), mono + f * hopSize, window.data(), fftSize);
+            juce::FloatVectorOperations::clear(fftData.data() + fftSize, fftSize);
+
+            fft.performFrequencyOnlyForwardTransform(fftData.data(), true);
+
+            juce::FloatVectorOperations::multiply(fftData.data(), fftData.data(), numBins);
+            juce::FloatVectorOperations::add(power.data(), fftData.data(), numBins);
+        }
+    }
+}
+
+//1/3 octave mean power at each grid point, in dB
+std::array<double, numGridPoints> smoothToGrid(const MatchEQ::Spectrum& spectrum)
+{
+    std::array<double, numGridPoints> result;
+    const auto binWidth = spectrum.sampleRate / fftSize;
+
+    for (int i = 0; i < numGridPoints; ++i)
+    {
+        const auto centre = gridLowest * std::pow(2.0, static_cast<double>(i) / pointsPerOctave);
+        const auto lowBin = juce::jlimit(1, numBins - 1, static_cast<int>(std::ceil(centre * std::pow(2.0, -1.0 / 6.0) / binWidth)));
+        const auto highBin = juce::jlimit(lowBin, numBins - 1, static_cast<int>(std::floor(centre * std::pow(2.0, 1.0 / 6.0) / binWidth)));
+
+        double sum = 0.0;
+        for (int bin = lowBin; bin <= highBin; ++bin)
+            sum += spectrum.power[static_cast<size_t>(bin)];
+
+        result[static_cast<size_t>(i)] = 10.0 * std::log10(sum / (highBin - lowBin + 1) + 1.0e-30);
+    }
+
+    return result;
+}
+
+MatchedDesign::Shape toShape(FilterInfo::FilterType type)
+{
+    return type == FilterInfo::Peak ? MatchedDesign::Peak : (type == FilterInfo::LowShelf ? MatchedDesign::LowShelf : MatchedDesign::HighShelf);
+}
+
+} //end anonymous namespace
+
+//==============================================================================
+
+MatchEQ::MatchEQ(Project11AudioProcessor& processor)
+    : juce::Thread("MatchEQ"), audioProcessor(processor)
+{
+}
+
+MatchEQ::~MatchEQ()
+{
+    stopThread(5000);
+}
+
+bool MatchEQ::start(const juce::File& reference, const juce::File& mix, std::function<void(const Result&)> onFinished)
+{
+    if (isThreadRunning())
+        return false;
+
+    referenceFile = reference;
+    mixFile = mix;
+    finishedCallback = std::move(onFinished);
+
+    startThread();
+    return true;
+}
+
+void MatchEQ::run()
+{
+    Trace::Scope scope {"MatchEQ"};
+
+    const auto result = analyseAndFit(referenceFile, mixFile, juce::jlimit(1, 32, juce::SystemStats::getNumCpus()), this);
+
+    if (threadShouldExit())
+        return;
+
+    juce::WeakReference<MatchEQ> weakThis {this};
+    juce::MessageManager::callAsync([weakThis, result]
+    {
+        if (auto* matchEQ = weakThis.get())
+        {
+            if (result.ok)
+                matchEQ->apply(result);
+
+            if (matchEQ->finishedCallback != nullptr)
+                matchEQ->finishedCallback(result);
+        }
+    });
+}
+
+MatchEQ::Result MatchEQ::analyseAndFit(const juce::File& reference, const juce::File& mix, int numThreads,
+                                       const juce::Thread* threadToCheck)
+{
+    const auto startTicks = juce::Time::getHighResolutionTicks();
+
+    Result result;
+    Spectrum referenceSpectrum, mixSpectrum;
+
+    if (analyse(reference, numThreads, referenceSpectrum, result.error, threadToCheck)
+        && analyse(mix, numThreads, mixSpectrum, result.error, threadToCheck))
+    {
+        result = fit(referenceSpectrum, mixSpectrum);
+    }
+
+    result.analysisSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+    return result;
+}
+
+void MatchEQ::apply(const Result& result)
+{
+    auto& apvts = audioProcessor.apvts;
+
+    auto set = [&apvts](const juce::String& id, float value)
+    {
+        if (auto* parameter = apvts.getParameter(id))
+        {
+            parameter->beginChangeGesture();
+            parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+            parameter->endChangeGesture();
+        }
+    };
+
+    set(generateTypeParamString(0), static_cast<float>(result.type));
+    set(generateFreqParamString(0), result.frequency);
+    set(generateQParamString(0), result.quality);
+    set(generateGainParamString(0), result.gainInDecibels);
+    /*the fit is of the analog prototype; bilinear would cramp it near Nyquist and miss what was matched. Costs the audio
+     thread one design, the method is picked off it (MatchedDesign::MethodPicker).*/
+    set(generateDesignParamString(0), 1.f);
+    set(generateBypassParamString(0), 0.f);
+}
+
+//==============================================================================
+
+bool MatchEQ::analyse(const juce::File& file, int numThreads, Spectrum& result, juce::String& error, const juce::Thread* threadToCheck)
+{
+    Trace::Scope scope {"MatchEQ::analyse"};
+
+    juce::AudioFormatManager formats;
+    formats.registerBasicFormats();
+
+    auto reader = createReader(formats, file);
+    if (reader == nullptr)
+    {
+        error = "Couldn't read " + file.getFileName();
+        return false;
+    }
+
+    const auto length = reader->lengthInSamples;
+    result.sampleRate = reader->sampleRate;
+    result.numFrames = length <= fftSize ? 1 : (length - fftSize + hopSize - 1) / hopSize + 1;
+    result.power.assign(numBins, 0.f);
+
+    if (length == 0 || result.sampleRate <= 0.0)
+    {
+        error = file.getFileName() + " is empty";
+        return false;
+    }
+
+    //one contiguous run of frames per worker, each with its own reader and its own accumulator
+    numThreads = static_cast<int>(juce::jlimit<juce::int64>(1, numThreads, result.numFrames / framesPerChunk + 1));
+    std::vector<std::vector<float>> partials(static_cast<size_t>(numThreads), std::vector<float>(numBins, 0.f));
+    //one flag per worker, each only written by its own; a worker that can't open the file leaves its frames at zero
+    std::vector<char> opened(static_cast<size_t>(numThreads), 0);
+    std::vector<std::thread> workers;
+
+    for (int t = 0; t < numThreads; ++t)
+    {
+        const auto first = result.numFrames * t / numThreads;
+        const auto end = result.numFrames * (t + 1) / numThreads;
+        auto& partial = partials[static_cast<size_t>(t)];
+        auto& workerOpened = opened[static_cast<size_t>(t)];
+
+        workers.emplace_back([&file, first, end, &partial, &workerOpened, threadToCheck]
+        {
+            juce::AudioFormatManager workerFormats;
+            workerFormats.registerBasicFormats();
+
+            if (auto workerReader = createReader(workerFormats, file))
+            {
+                workerOpened = 1;
+                analyseFrames(*workerReader, first, end, partial, threadToCheck);
+            }
+        });
+    }
+
+    for (auto& worker : workers)
+        worker.join();
+
+    if (std::find(opened.begin(), opened.end(), 0) != opened.end())
+    {
+        error = "Couldn't read " + file.getFileName() + " on every analysis thread";
+        return false;
+    }
+
+    for (const auto& partial : partials)
+        juce::FloatVectorOperations::add(result.power.data(), partial.data(), numBins);
+
+    juce::FloatVectorOperations::multiply(result.power.data(), 1.f / static_cast<float>(result.numFrames), numBins);
+
+    return threadToCheck == nullptr || ! threadToCheck->threadShouldExit();
+}
+
+MatchEQ::Result MatchEQ::fit(const Spectrum& reference, const Spectrum& mix)
+{
+    Trace::Scope scope {"MatchEQ::fit"};
+
+    using namespace FilterInfo;
+
+    Result result;
+
+    const auto referenceDb = smoothToGrid(reference);
+    const auto mixDb = smoothToGrid(mix);
+    const auto referenceMax = *std::max_element(referenceDb.begin(), referenceDb.end());
+    const auto mixMax = *std::max_element(mixDb.begin(), mixDb.end());
+    const auto nyquist = 0.5 * juce::jmin(reference.sampleRate, mix.sampleRate);
+
+    //what the band has to add, with the overall level difference taken out
+    std::array<double, numGridPoints> frequencies, target, weights;
+    double weightSum = 0.0, meanDifference = 0.0;
+
+    for (int i = 0; i < numGridPoints; ++i)
+    {
+        const auto index = static_cast<size_t>(i);
+        frequencies[index] = gridLowest * std::pow(2.0, static_cast<double>(i) / pointsPerOctave);
+        target[index] = referenceDb[index] - mixDb[index];
+
+        const auto usable = frequencies[index] < nyquist
+                            && referenceDb[index] > referenceMax - floorDb
+                            && mixDb[index] > mixMax - floorDb;
+        weights[index] = usable ? 1.0 : 0.0;
+
+        weightSum += weights[index];
+        meanDifference += weights[index] * target[index];
+    }
+
+    if (weightSum < 3.0)
+    {
+        result.error = "Not enough signal in common to match";
+        return result;
+    }
+
+    meanDifference /= weightSum;
+    for (auto& t : target)
+        t -= meanDifference;
+
+    //the values the parameters can actually hold
+    auto gainRange = juce::NormalisableRange<float>(-24.f, 24.f, 1.f);
+    auto qRange = juce::NormalisableRange<float>(0.1f, 10.f, 0.5f);
+
+    /*How far the band is from the target once the best level offset is taken out as well: a boost lifts the mean
+     difference too, so the offset has to be fitted with the band, not before it.*/
+    auto error = [&](MatchedDesign::Shape shape, double freq, double q, double gainDb)
+    {
+        std::array<double, numGridPoints> difference;
+        double mean = 0.0;
+
+        for (size_t i = 0; i < frequencies.size(); ++i)
+        {
+            if (weights[i] == 0.0)
+                continue;
+
+            const auto model = 20.0 * std::log10(MatchedDesign::getAnalogMagnitude(shape, freq, q, gainDb, frequencies[i]));
+            difference[i] = model - target[i];
+            mean += difference[i];
+        }
+
+        mean /= weightSum;
+
+        double sum = 0.0;
+        for (size_t i = 0; i < frequencies.size(); ++i)
+            if (weights[i] != 0.0)
+                sum += (difference[i] - mean) * (difference[i] - mean);
+
+        return sum;
+    };
+
+    //for a given shape, frequency and Q: least squares gain from the curve's shape at 12dB, then the nearest steps
+    auto bestGainFor = [&](MatchedDesign::Shape shape, double freq, double q, double& bestError)
+    {
+        std::array<double, numGridPoints> unit;
+        double unitMean = 0.0;
+
+        for (size_t i = 0; i < frequencies.size(); ++i)
+        {
+            unit[i] = 20.0 * std::log10(MatchedDesign::getAnalogMagnitude(shape, freq, q, 12.0, frequencies[i])) / 12.0;
+            unitMean += weights[i] * unit[i];
+        }
+
+        unitMean /= weightSum;
+
+        //target already has its mean taken out
+        double numerator = 0.0, denominator = 0.0;
+        for (size_t i = 0; i < frequencies.size(); ++i)
+        {
+            numerator += weights[i] * (unit[i] - unitMean) * target[i];
+            denominator += weights[i] * (unit[i] - unitMean) * (unit[i] - unitMean);
+        }
+
+        const auto estimate = gainRange.snapToLegalValue(static_cast<float>(denominator > 0.0 ? numerator / denominator : 0.0));
+
+        float bestGain = 0.f;
+        bestError = std::numeric_limits<double>::max();
+        for (int step = -1; step <= 1; ++step)
+        {
+            const auto gain = juce::jlimit(gainRange.start, gainRange.end, estimate + step * gainRange.interval);
+            const auto e = error(shape, freq, q, gain);
+            if (e < bestError)
+            {
+                bestError = e;
+                bestGain = gain;
+            }
+        }
+        return bestGain;
+    };
+
+    const auto highest = juce::jmin(20000.0, nyquist * 0.95);
+    double bestError = std::numeric_limits<double>::max();
+
+    auto tryCandidate = [&](FilterType type, double freq, float q)
+    {
+        double e = 0.0;
+        const auto gain = bestGainFor(toShape(type), freq, q, e);
+        if (e < bestError)
+        {
+            bestError = e;
+            result.type = type;
+            result.frequency = static_cast<float>(freq);
+            result.quality = q;
+            result.gainInDecibels = gain;
+        }
+    };
+
+    //coarse: 1/6 octave over the whole range, every Q step
+    for (auto type : { Peak, LowShelf, HighShelf })
+        for (auto freq = gridLowest; freq <= highest; freq *= std::pow(2.0, 1.0 / 6.0))
+            for (auto q = qRange.start; q <= qRange.end; q += qRange.interval)
+                tryCandidate(type, freq, q);
+
+    //fine: 1/48 octave around the best frequency, neighbouring Q steps
+    const auto coarseType = result.type;
+    const auto coarseFreq = static_cast<double>(result.frequency);
+    const auto coarseQ = result.quality;
+
+    for (int step = -8; step <= 8; ++step)
+    {
+        const auto freq = juce::jlimit(gridLowest, highest, coarseFreq * std::pow(2.0, step / 48.0));
+        for (int qStep = -1; qStep <= 1; ++qStep)
+        {
+            const auto q = juce::jlimit(qRange.start, qRange.end, coarseQ + qStep * qRange.interval);
+            tryCandidate(coarseType, freq, q);
+        }
+    }
+
+    result.frequency = std::round(result.frequency);
+    result.residualDb = static_cast<float>(std::sqrt(error(toShape(result.type), result.frequency, result.quality, result.gainInDecibels) / weightSum));
+    result.ok = true;
+
+    return result;
+}
@@ -0,0 +1,88 @@
+/*
+  ==============================================================================
+
+    MatchEQ.h
+    Created: 20 Oct 2026 10:03:51am
+    Author:  Marc Woodbury-Smith
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+/*Offline match EQ: set the band so a mix sounds like a reference.
+
+ Both files get a long term average spectrum (Hann windowed, 50% overlap, mono sum). Each file is cut into one
+ contiguous run of frames per core; every worker opens its own reader (memory mapped where the format allows it,
+ streaming otherwise), so nothing is shared but the result. The window and the power accumulation go through
+ juce::FloatVectorOperations, and the FFT through juce::dsp::FFT. That's vDSP on the Mac; on Windows and Linux it's
+ juce's scalar fallback unless the build links IPP, or FFTW or MKL through the juce_dsp JUCE_DSP_USE_* options, none of
+ which this project ships. HostSimulation::runMatch() times a pair.
+
+ The two spectra are smoothed to 1/3 octave on a common log grid (so the files don't need the same sample rate), the
+ level difference is taken out (that's AutoGain's job, not the band's) and what's left is fitted with the band: every type
+ with gain (Peak, LowShelf, HighShelf), frequency on a 1/6 octave grid refined to 1/48, and Q and gain on the exact
+ steps the parameters allow, so nothing moves when the values are snapped. The fit uses the analog prototype, which is
+ what the analog matched design follows, so the band is switched to that design along with the fitted values.
+
+ Everything runs on a background thread and its workers. The result is written to apvts from the message thread, as
+ if the user had moved the controls; the audio thread only ever sees new parameter values.*/
+class MatchEQ : private juce::Thread
+{
+public:
+    struct Result
+    {
+        bool ok {false};
+        juce::String error;
+
+        FilterInfo::FilterType type {FilterInfo::Peak};
+        float frequency {1000.f};
+        float quality {1.f};
+        float gainInDecibels {0.f};
+
+        //RMS of what the band couldn't match, in dB over the fitted range
+        float residualDb {0.f};
+        double analysisSeconds {0.0};
+    };
+
+    explicit MatchEQ(Project11AudioProcessor& processor);
+    ~MatchEQ() override;
+
+    /*Message thread. Analyses both files, applies the fit and then calls onFinished (message thread again).
+     Returns false if an analysis is already running.*/
+    bool start(const juce::File& reference, const juce::File& mix, std::function<void(const Result&)> onFinished);
+
+    bool isAnalysing() const { return isThreadRunning(); }
+
+    //the two halves of the work, usable without a processor (a benchmark, a command line tool)
+    struct Spectrum
+    {
+        //mean power per FFT bin
+        std::vector<float> power;
+        double sampleRate {0.0};
+        juce::int64 numFrames {0};
+    };
+
+    static bool analyse(const juce::File& file, int numThreads, Spectrum& result, juce::String& error,
+                        const juce::Thread* threadToCheck = nullptr);
+
+    static Result fit(const Spectrum& reference, const Spectrum& mix);
+
+    //both analyses and the fit, as start() runs them; analysisSeconds is the wall time of all three
+    static Result analyseAndFit(const juce::File& reference, const juce::File& mix, int numThreads,
+                                const juce::Thread* threadToCheck = nullptr);
+
+private:
+    void run() override;
+    void apply(const Result& result);
+
+    Project11AudioProcessor& audioProcessor;
+
+    juce::File referenceFile, mixFile;
+    std::function<void(const Result&)> finishedCallback;
+
+    JUCE_DECLARE_WEAK_REFERENCEABLE(MatchEQ)
+    JUCE_DECLARE_NON_COPYABLE(MatchEQ)
+};
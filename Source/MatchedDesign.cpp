@@ -0,0 +1,442 @@
+/*
+  ==============================================================================
+
+    MatchedDesign.cpp
+    Created: 19 Oct 2026 9:14:26pm
+    Author:  Marc Woodbury-Smith
+
+  ==============================================================================
+*/
+
+#include "MatchedDesign.h"
+
+namespace MatchedDesign
+{
+
+namespace
+{
+
+//analog biquad (n2 s^2 + n1 s + n0) / (d2 s^2 + d1 s + d0), s normalised to the centre frequency
+struct Prototype
+{
+    double n2, n1, n0;
+    double d2, d1, d0;
+};
+
+Prototype makePrototype(Shape shape, double q, double gainInDecibels)
+{
+    //A as the RBJ cookbook has it: sqrt of the linear gain
+    const auto A = std::pow(10.0, gainInDecibels / 40.0);
+    const auto rootA = std::sqrt(A);
+    q = juce::jmax(0.01, q);
+
+    switch (shape)
+    {
+        case LowShelf:
+            return { A, A * rootA / q, A * A,   A, rootA / q, 1.0 };
+        case HighShelf:
+            return { A * A, A * rootA / q, A,   1.0, rootA / q, A };
+        case Peak:
+        default:
+            return { 1.0, A / q, 1.0,   1.0, 1.0 / (A * q), 1.0 };
+    }
+}
+
+//|H(j omega)|^2, omega relative to the centre frequency
+double squaredMagnitude(const Prototype& p, double omega)
+{
+    const auto omega2 = omega * omega;
+    const auto numRe = p.n0 - p.n2 * omega2;
+    const auto numIm = p.n1 * omega;
+    const auto denRe = p.d0 - p.d2 * omega2;
+    const auto denIm = p.d1 * omega;
+
+    return (numRe * numRe + numIm * numIm) / (denRe * denRe + denIm * denIm);
+}
+
+//a biquad in double, a0 = 1. Rounded to float once the design is finished.
+struct Biquad
+{
+    double b0, b1, b2, a1, a2;
+};
+
+SlopeDesign::Section toSection(const Biquad& biquad)
+{
+    SlopeDesign::Section section;
+    section.b0 = static_cast<float>(biquad.b0);
+    section.b1 = static_cast<float>(biquad.b1);
+    section.b2 = static_cast<float>(biquad.b2);
+    section.a1 = static_cast<float>(biquad.a1);
+    section.a2 = static_cast<float>(biquad.a2);
+    return section;
+}
+
+double getOmega(double freq, double sampleRate)
+{
+    return juce::MathConstants<double>::twoPi * juce::jlimit(2.0, 0.499 * sampleRate, freq) / sampleRate;
+}
+
+//the roots of d2 s^2 + d1 s + d0, mapped through z = exp(sT), as the 1, c1, c2 of a z polynomial
+void mapRoots(double d2, double d1, double d0, double w0, double& c1, double& c2)
+{
+    const auto re = -d1 / (2.0 * d2) * w0;
+    const auto discriminant = d1 * d1 - 4.0 * d2 * d0;
+
+    if (discriminant < 0.0)
+    {
+        //only a safety net for the shapes fitted here: a root above Nyquist would alias back down as a resonance
+        const auto im = juce::jmin(juce::MathConstants<double>::pi, std::sqrt(-discriminant) / (2.0 * d2) * w0);
+        c1 = -2.0 * std::exp(re) * std::cos(im);
+        c2 = std::exp(2.0 * re);
+    }
+    else
+    {
+        const auto spread = std::sqrt(discriminant) / (2.0 * d2) * w0;
+        c1 = -(std::exp(re + spread) + std::exp(re - spread));
+        c2 = std::exp(2.0 * re);
+    }
+}
+
+/*The 3 point fit, for boosts only (Peak or LowShelf). A boost's zeros come out minimum phase, so its reciprocal is
+ stable too; see designBoostBased() for how everything else is built from these two.*/
+Biquad fitBoost(Shape shape, double freq, double q, double gainInDecibels, double sampleRate)
+{
+    const auto prototype = makePrototype(shape, q, gainInDecibels);
+    const auto w0 = getOmega(freq, sampleRate);
+
+    double a1, a2;
+    mapRoots(prototype.d2, prototype.d1, prototype.d0, w0, a1, a2);
+
+    /*|H(w)|^2 = (B0 phi0 + B1 phi1 + B2 phi2) / (A0 phi0 + A1 phi1 + A2 phi2)
+     with phi1 = sin^2(w/2), phi0 = 1 - phi1, phi2 = 4 phi0 phi1, A0 = (1 + a1 + a2)^2, A1 = (1 - a1 + a2)^2, A2 = -4 a2,
+     and the same for B from the b's. phi2 is 0 at DC and Nyquist, so those two fix B0 and B1 directly, w0 gives B2.*/
+    const auto A0 = (1.0 + a1 + a2) * (1.0 + a1 + a2);
+    const auto A1 = (1.0 - a1 + a2) * (1.0 - a1 + a2);
+    const auto A2 = -4.0 * a2;
+
+    const auto phi1 = std::pow(std::sin(w0 * 0.5), 2.0);
+    const auto phi0 = 1.0 - phi1;
+    const auto phi2 = 4.0 * phi0 * phi1;
+
+    const auto atDc = squaredMagnitude(prototype, 0.0);
+    const auto atNyquist = squaredMagnitude(prototype, juce::MathConstants<double>::pi / w0);
+    const auto atCentre = squaredMagnitude(prototype, 1.0);
+
+    const auto B0 = atDc * A0;
+    const auto B1 = atNyquist * A1;
+    const auto B2 = (atCentre * (A0 * phi0 + A1 * phi1 + A2 * phi2) - B0 * phi0 - B1 * phi1) / phi2;
+
+    //back to b's, taking the minimum phase root
+    const auto rootB0 = std::sqrt(B0);
+    const auto rootB1 = std::sqrt(B1);
+    const auto W = 0.5 * (rootB0 + rootB1);
+
+    const auto b0 = 0.5 * (W + std::sqrt(juce::jmax(0.0, W * W + B2)));
+    const auto b1 = 0.5 * (rootB0 - rootB1);
+    const auto b2 = b0 != 0.0 ? -B2 / (4.0 * b0) : 0.0;
+
+    return { b0, b1, b2, a1, a2 };
+}
+
+//poles and zeros both through exp(sT), then scaled so DC has the analog gain. Boosts only, like fitBoost().
+Biquad mapBoost(Shape shape, double freq, double q, double gainInDecibels, double sampleRate)
+{
+    const auto prototype = makePrototype(shape, q, gainInDecibels);
+    const auto w0 = getOmega(freq, sampleRate);
+
+    double a1, a2, c1, c2;
+    mapRoots(prototype.d2, prototype.d1, prototype.d0, w0, a1, a2);
+    mapRoots(prototype.n2, prototype.n1, prototype.n0, w0, c1, c2);
+
+    const auto scale = std::sqrt(squaredMagnitude(prototype, 0.0)) * std::abs(1.0 + a1 + a2) / std::abs(1.0 + c1 + c2);
+    return { scale, scale * c1, scale * c2, a1, a2 };
+}
+
+//scale / H: poles and zeros swap places
+Biquad reciprocal(const Biquad& biquad, double scale)
+{
+    return { scale / biquad.b0, scale * biquad.a1 / biquad.b0, scale * biquad.a2 / biquad.b0,
+             biquad.b1 / biquad.b0, biquad.b2 / biquad.b0 };
+}
+
+Biquad designBoostBased(Shape shape, double freq, double q, double gainInDecibels, double sampleRate,
+                        Biquad (*designBoost)(Shape, double, double, double, double))
+{
+    /*Only boosts get designed directly. A cut's deep zeros are what a 3 point fit of the numerator can't find, but
+     every cut prototype is the reciprocal of the boost with the same |gain|.
+     A high shelf's poles sit above its corner and run into Nyquist, a low shelf's sit below it, and
+     HighShelf(g) == G / LowShelf(g) for linear gain G, so high shelves are built from low shelves.*/
+    const auto boostDb = std::abs(gainInDecibels);
+    const auto isCut = gainInDecibels < 0.0;
+
+    if (shape == HighShelf)
+    {
+        const auto gain = std::pow(10.0, gainInDecibels / 20.0);
+        auto lowShelf = designBoost(LowShelf, freq, q, boostDb, sampleRate);
+
+        if (! isCut)
+            return reciprocal(lowShelf, gain);
+
+        return { lowShelf.b0 * gain, lowShelf.b1 * gain, lowShelf.b2 * gain, lowShelf.a1, lowShelf.a2 };
+    }
+
+    const auto boost = designBoost(shape, freq, q, boostDb, sampleRate);
+    return isCut ? reciprocal(boost, 1.0) : boost;
+}
+
+//the RBJ cookbook, as in the juce factories
+Biquad designBilinear(Shape shape, double freq, double q, double gainInDecibels, double sampleRate)
+{
+    const auto A = std::pow(10.0, gainInDecibels / 40.0);
+    const auto w0 = juce::MathConstants<double>::twoPi * juce::jmax(2.0, freq) / sampleRate;
+    const auto cosW0 = std::cos(w0);
+    const auto sinW0 = std::sin(w0);
+    q = juce::jmax(0.01, q);
+
+    double b0, b1, b2, a0, a1, a2;
+
+    if (shape == Peak)
+    {
+        const auto alpha = sinW0 / (2.0 * q);
+        b0 = 1.0 + alpha * A;  b1 = -2.0 * cosW0;  b2 = 1.0 - alpha * A;
+        a0 = 1.0 + alpha / A;  a1 = -2.0 * cosW0;  a2 = 1.0 - alpha / A;
+    }
+    else
+    {
+        const auto aMinus1 = A - 1.0;
+        const auto aPlus1 = A + 1.0;
+        const auto aMinus1TimesCos = aMinus1 * cosW0;
+        const auto beta = sinW0 * std::sqrt(A) / q;
+
+        if (shape == LowShelf)
+        {
+            b0 = A * (aPlus1 - aMinus1TimesCos + beta);
+            b1 = A * 2.0 * (aMinus1 - aPlus1 * cosW0);
+            b2 = A * (aPlus1 - aMinus1TimesCos - beta);
+            a0 = aPlus1 + aMinus1TimesCos + beta;
+            a1 = -2.0 * (aMinus1 + aPlus1 * cosW0);
+            a2 = aPlus1 + aMinus1TimesCos - beta;
+        }
+        else
+        {
+            b0 = A * (aPlus1 + aMinus1TimesCos + beta);
+            b1 = A * -2.0 * (aMinus1 + aPlus1 * cosW0);
+            b2 = A * (aPlus1 + aMinus1TimesCos - beta);
+            a0 = aPlus1 - aMinus1TimesCos + beta;
+            a1 = 2.0 * (aMinus1 - aPlus1 * cosW0);
+            a2 = aPlus1 - aMinus1TimesCos - beta;
+        }
+    }
+
+    return { b0 / a0, b1 / a0, b2 / a0, a1 / a0, a2 / a0 };
+}
+
+/*getWorstErrorDb() for several sections at once, so the grid and the prototype are only worked out once. |H|^2 in the
+ phi form (see fitBoost()), which keeps its precision near DC where the poles crowd 1.*/
+template <size_t N>
+std::array<double, N> getWorstErrorsDb(const std::array<SlopeDesign::Section, N>& sections, Shape shape, double freq,
+                                       double q, double gainInDecibels, double sampleRate)
+{
+    const auto prototype = makePrototype(shape, q, gainInDecibels);
+    const auto centre = juce::jmax(1.0e-3, freq);
+
+    std::array<double, N> lowestRatio, highestRatio;
+    lowestRatio.fill(1.0);
+    highestRatio.fill(1.0);
+
+    //1/12 octave, and 1/96 within an octave of the centre, where a high Q peak or a shelf's bump is narrower than that
+    const auto coarseStep = std::pow(2.0, 1.0 / 12.0);
+    const auto fineStep = std::pow(2.0, 1.0 / 96.0);
+
+    for (auto f = 20.0; f < 0.5 * sampleRate; f *= (f >= 0.5 * centre && f < 2.0 * centre) ? fineStep : coarseStep)
+    {
+        const auto target = squaredMagnitude(prototype, f / centre);
+
+        const auto phi1 = std::pow(std::sin(juce::MathConstants<double>::pi * f / sampleRate), 2.0);
+        const auto phi0 = 1.0 - phi1;
+        const auto phi2 = 4.0 * phi0 * phi1;
+
+        for (size_t i = 0; i < N; ++i)
+        {
+            const auto& s = sections[i];
+            const double b0 = s.b0, b1 = s.b1, b2 = s.b2, a1 = s.a1, a2 = s.a2;
+
+            const auto numerator = (b0 + b1 + b2) * (b0 + b1 + b2) * phi0 + (b0 - b1 + b2) * (b0 - b1 + b2) * phi1 - 4.0 * b0 * b2 * phi2;
+            const auto denominator = (1.0 + a1 + a2) * (1.0 + a1 + a2) * phi0 + (1.0 - a1 + a2) * (1.0 - a1 + a2) * phi1 - 4.0 * a2 * phi2;
+            const auto ratio = numerator / (denominator * target);
+
+            lowestRatio[i] = juce::jmin(lowestRatio[i], ratio);
+            highestRatio[i] = juce::jmax(highestRatio[i], ratio);
+        }
+    }
+
+    //squared magnitudes, so 10 log10
+    std::array<double, N> errors;
+    for (size_t i = 0; i < N; ++i)
+        errors[i] = 10.0 * juce::jmax(std::log10(highestRatio[i]), -std::log10(juce::jmax(1.0e-30, lowestRatio[i])));
+
+    return errors;
+}
+
+} //end anonymous namespace
+
+//==============================================================================
+
+SlopeDesign::Section design(Shape shape, double freq, double q, double gainInDecibels, double sampleRate, Method method) noexcept
+{
+    switch (method)
+    {
+        case PoleZero:
+            return toSection(designBoostBased(shape, freq, q, gainInDecibels, sampleRate, mapBoost));
+        case Bilinear:
+            return toSection(designBilinear(shape, freq, q, gainInDecibels, sampleRate));
+        case ThreePointFit:
+        default:
+            return toSection(designBoostBased(shape, freq, q, gainInDecibels, sampleRate, fitBoost));
+    }
+}
+
+Method pickMethod(Shape shape, double freq, double q, double gainInDecibels, double sampleRate) noexcept
+{
+    //in the order of the enum, so a tie goes to the matched designs
+    const std::array<SlopeDesign::Section, 3> candidates { design(shape, freq, q, gainInDecibels, sampleRate, ThreePointFit),
+                                                           design(shape, freq, q, gainInDecibels, sampleRate, PoleZero),
+                                                           design(shape, freq, q, gainInDecibels, sampleRate, Bilinear) };
+
+    const auto errors = getWorstErrorsDb(candidates, shape, freq, q, gainInDecibels, sampleRate);
+    return static_cast<Method>(std::min_element(errors.begin(), errors.end()) - errors.begin());
+}
+
+SlopeDesign::Section design(Shape shape, double freq, double q, double gainInDecibels, double sampleRate) noexcept
+{
+    return design(shape, freq, q, gainInDecibels, sampleRate, pickMethod(shape, freq, q, gainInDecibels, sampleRate));
+}
+
+double getWorstErrorDb(const SlopeDesign::Section& section, Shape shape, double freq, double q, double gainInDecibels,
+                       double sampleRate) noexcept
+{
+    return getWorstErrorsDb(std::array<SlopeDesign::Section, 1> { section }, shape, freq, q, gainInDecibels, sampleRate)[0];
+}
+
+double getAnalogMagnitude(Shape shape, double freq, double q, double gainInDecibels, double atFrequency) noexcept
+{
+    return std::sqrt(squaredMagnitude(makePrototype(shape, q, gainInDecibels), atFrequency / juce::jmax(1.0e-3, freq)));
+}
+
+//==============================================================================
+
+MethodPicker::MethodPicker()
+{
+    worker->add(*this);
+}
+
+MethodPicker::~MethodPicker()
+{
+    worker->remove(*this);
+}
+
+Method MethodPicker::getMethod(const Settings& settings) noexcept
+{
+    //collect whatever the worker picked since the last call
+    if (resultVersion.load(std::memory_order_acquire) != seenResult)
+    {
+        const juce::SpinLock::ScopedTryLockType tryLock(lock);
+        if (tryLock.isLocked())
+        {
+            pickedFor = resultFor;
+            picked = result;
+            hasPicked = true;
+            seenResult = resultVersion.load(std::memory_order_relaxed);
+        }
+    }
+
+    if (hasPicked && pickedFor == settings)
+        return picked;
+
+    if (!isHandedOver || !(handedOver == settings))
+    {
+        const juce::SpinLock::ScopedTryLockType tryLock(lock);
+        isHandedOver = tryLock.isLocked();
+
+        if (isHandedOver)
+        {
+            pending = settings;
+            isPending = true;
+            handedOver = settings;
+            worker->notify();
+        }
+    }
+
+    return picked;
+}
+
+void MethodPicker::pickPending()
+{
+    Settings settings;
+    {
+        const juce::SpinLock::ScopedLockType sl(lock);
+        if (!isPending)
+            return;
+
+        settings = pending;
+        isPending = false;
+    }
+
+    const auto method = pickMethod(settings.shape, settings.freq, settings.q, settings.gainInDecibels, settings.sampleRate);
+
+    const juce::SpinLock::ScopedLockType sl(lock);
+    resultFor = settings;
+    result = method;
+    resultVersion.fetch_add(1, std::memory_order_release);
+}
+
+MethodPicker::Worker::Worker() : juce::Thread("Project11 MethodPicker")
+{
+    startThread();
+}
+
+MethodPicker::Worker::~Worker()
+{
+    stopThread(1000);
+}
+
+void MethodPicker::Worker::add(MethodPicker& picker)
+{
+    const juce::ScopedLock sl(lock);
+    pickers.addIfNotAlreadyThere(&picker);
+}
+
+void MethodPicker::Worker::remove(MethodPicker& picker)
+{
+    const juce::ScopedLock sl(lock);
+    pickers.removeFirstMatchingValue(&picker);
+}
+
+void MethodPicker::Worker::notify() noexcept
+{
+    workPending.store(true, std::memory_order_release);
+}
+
+void MethodPicker::Worker::run()
+{
+    while (!threadShouldExit())
+    {
+        wait(pollIntervalMs);
+
+        //cleared before looking, so a handover that lands during the sweep is picked up on the next poll
+        if (!workPending.exchange(false, std::memory_order_acq_rel))
+            continue;
+
+        const juce::ScopedLock sl(lock);
+
+        for (auto* picker : pickers)
+        {
+            if (threadShouldExit())
+                break;
+
+            picker->pickPending();
+        }
+    }
+}
+
+} //end namespace MatchedDesign
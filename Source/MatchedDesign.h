@@ -0,0 +1,158 @@
+/*
+  ==============================================================================
+
+    MatchedDesign.h
+    Created: 19 Oct 2026 9:14:26pm
+    Author:  Marc Woodbury-Smith
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "SlopeDesign.h"
+
+/*Peak and shelf biquads whose magnitude follows the analog prototype all the way to Nyquist, after Vicanek
+ ("Matched Second Order Digital Filters", 2016).
+
+ The bilinear transform squeezes the whole analog axis into 0..Nyquist, so an RBJ peak at 15kHz on 44.1kHz comes out
+ narrower than asked for and a high shelf never reaches its gain. Here the poles come from the analog ones by
+ z = exp(sT) (no squeezing), and the zeros are whatever makes |H| equal the analog |H| at three frequencies: DC,
+ Nyquist and the centre/corner frequency. Any biquad's |H|^2 is linear in three numbers once the poles are fixed, so
+ that's a 3 point fit with a closed form answer.
+
+ Three points don't pin down everything. A high Q shelf has a bump and a dip either side of its corner, and between the
+ fitted points the 3 point fit can swing further off than the bilinear design does. So there are three candidates:
+
+     ThreePointFit  the fit above
+     PoleZero       zeros mapped through exp(sT) like the poles, scaled to the analog gain at DC. Follows the bump and
+                    dip of a high Q shelf closely, but drifts off at Nyquist where the fit pins it.
+     Bilinear       the RBJ cookbook, same as the juce factories. At very low frequencies the matched poles and zeros
+                    are too close to 1 for float, and this one rounds better.
+
+ and design() keeps whichever has the smallest worst case error against the analog prototype (getWorstErrorDb()), so
+ "Analog matched" is never further off than the bilinear design. Everything is worked out in double and rounded to
+ float at the end. Nothing allocates.
+
+ Picking costs the three designs and ~300 magnitude evaluations each, some 10us against well under 1us for one design,
+ so the audio thread never picks: a MethodPicker picks on a background thread and the band designs with the method it
+ hands back.*/
+namespace MatchedDesign
+{
+
+enum Shape
+{
+    Peak,
+    LowShelf,
+    HighShelf
+};
+
+enum Method
+{
+    ThreePointFit,
+    PoleZero,
+    Bilinear
+};
+
+//gain in dB, q as the juce factories take it. freq is kept just under Nyquist. The best of the three methods.
+SlopeDesign::Section design(Shape shape, double freq, double q, double gainInDecibels, double sampleRate) noexcept;
+
+//one method, whichever it is
+SlopeDesign::Section design(Shape shape, double freq, double q, double gainInDecibels, double sampleRate, Method method) noexcept;
+
+//the method with the smallest worst case error for these settings
+Method pickMethod(Shape shape, double freq, double q, double gainInDecibels, double sampleRate) noexcept;
+
+/*Worst |dB| difference between section and the analog prototype, from 20Hz to Nyquist: 1/12 octave steps, 1/96 within
+ an octave of freq. Takes
+ any biquad: it's how the methods are compared, and how a bilinear design can be compared with them.*/
+double getWorstErrorDb(const SlopeDesign::Section& section, Shape shape, double freq, double q, double gainInDecibels,
+                       double sampleRate) noexcept;
+
+//|H| of the analog prototype the design is matched to, for checking how close any design gets
+double getAnalogMagnitude(Shape shape, double freq, double q, double gainInDecibels, double atFrequency) noexcept;
+
+/*pickMethod() off the calling thread. getMethod() hands the settings over and returns straight away with the method
+ picked for them if there is one, otherwise the last method picked (ThreePointFit before the first) as a stand-in. One
+ background thread, shared by every picker in the process, wakes every pollIntervalMs and picks for whichever pickers
+ have something new; during a drag only the latest settings get picked for. Calling getMethod() again with the same
+ settings, a block later say, gets the pick once it has landed.
+
+ getMethod() is for one thread at a time, the audio thread included: it never waits (the shared state is only
+ try-locked, a missed handover is retried on the next call) and never allocates. Construct and destroy on the message
+ thread.*/
+class MethodPicker
+{
+public:
+    struct Settings
+    {
+        Shape shape {Peak};
+        double freq {1000.0};
+        double q {1.0};
+        double gainInDecibels {0.0};
+        double sampleRate {44100.0};
+
+        bool operator==(const Settings& other) const noexcept
+        {
+            return shape == other.shape && freq == other.freq && q == other.q && gainInDecibels == other.gainInDecibels
+                && sampleRate == other.sampleRate;
+        }
+    };
+
+    MethodPicker();
+    ~MethodPicker();
+
+    Method getMethod(const Settings& settings) noexcept;
+
+private:
+    class Worker : private juce::Thread
+    {
+    public:
+        Worker();
+        ~Worker() override;
+
+        void add(MethodPicker& picker);
+        void remove(MethodPicker& picker);
+
+        //lock free, just a flag
+        void notify() noexcept;
+
+    private:
+        static constexpr int pollIntervalMs = 10;
+
+        void run() override;
+
+        //held while picking, so remove() returns only once the worker is done with that picker
+        juce::CriticalSection lock;
+        juce::Array<MethodPicker*> pickers;
+
+        std::atomic<bool> workPending {false};
+
+        JUCE_DECLARE_NON_COPYABLE (Worker)
+    };
+
+    //worker thread
+    void pickPending();
+
+    //only touched by the getMethod() thread
+    Settings handedOver;
+    bool isHandedOver = false;
+    Settings pickedFor;
+    Method picked = ThreePointFit;
+    bool hasPicked = false;
+    uint32_t seenResult = 0;
+
+    //shared, guarded by lock; getMethod() only ever try-locks it
+    juce::SpinLock lock;
+    Settings pending;
+    bool isPending = false;
+    Settings resultFor;
+    Method result = ThreePointFit;
+    std::atomic<uint32_t> resultVersion {0};
+
+    juce::SharedResourcePointer<Worker> worker;
+
+    JUCE_DECLARE_NON_COPYABLE (MethodPicker)
+};
+
+} //end namespace MatchedDesign
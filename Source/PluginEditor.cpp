@@ -8,18 +8,54 @@
 
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "Trace.h"
 
 //==============================================================================
 Project11AudioProcessorEditor::Project11AudioProcessorEditor (Project11AudioProcessor& p)
-    : AudioProcessorEditor (&p), audioProcessor (p)
+    : AudioProcessorEditor (&p), audioProcessor (p), responseCurveComponent (p), matchEQ (p)
 {
+    addAndMakeVisible (responseCurveComponent);
+    
+    traceButton.setClickingTogglesState (true);
+    traceButton.setToggleState (Trace::isEnabled(), juce::dontSendNotification);
+    traceButton.onClick = [this]
+    {
+        auto recording = traceButton.getToggleState();
+        Trace::setEnabled (recording);
+        
+        if (! recording)
+        {
+            auto file = juce::File::getSpecialLocation (juce::File::userDocumentsDirectory)
+                            .getChildFile ("Project11 trace " + juce::Time::getCurrentTime().formatted ("%Y-%m-%d %H-%M-%S") + ".json");
+            
+            Trace::flushToFile (file, [file] (bool ok)
+            {
+                DBG ((ok ? "Trace written to " : "Couldn't write trace to ") + file.getFullPathName());
+                juce::ignoreUnused (ok);
+            });
+        }
+    };
+    addAndMakeVisible (traceButton);
+    
+    matchButton.onClick = [this] { chooseMatchFiles(); };
+    addAndMakeVisible (matchButton);
+    
+    qualityLabel.setJustificationType (juce::Justification::centredRight);
+    qualityLabel.setColour (juce::Label::textColourId, juce::Colours::orange);
+    qualityLabel.setInterceptsMouseClicks (false, false);
+    addAndMakeVisible (qualityLabel);
+    updateQualityLabel();
+    
+    audioProcessor.analyzerEnabled.store (true);
+    
     // Make sure that before the constructor has finished, you've set the
     // editor's size to whatever you need it to be.
-    setSize (400, 300);
+    setSize (700, 400);
 }
 
 Project11AudioProcessorEditor::~Project11AudioProcessorEditor()
 {
+    audioProcessor.analyzerEnabled.store (false);
 }
 
 //==============================================================================
@@ -27,14 +63,64 @@ void Project11AudioProcessorEditor::paint (juce::Graphics& g)
 {
     // (Our component is opaque, so we must completely fill the background with a solid colour)
     g.fillAll (getLookAndFeel().findColour (juce::ResizableWindow::backgroundColourId));
-
-    g.setColour (juce::Colours::white);
-    g.setFont (15.0f);
-    g.drawFittedText ("Hello World!", getLocalBounds(), juce::Justification::centred, 1);
 }
 
 void Project11AudioProcessorEditor::resized()
 {
-    // This is generally where you'll want to lay out the positions of any
-    // subcomponents in your editor..
+    responseCurveComponent.setBounds (getLocalBounds());
+    traceButton.setBounds (getWidth() - 70, 5, 60, 22);
+    matchButton.setBounds (getWidth() - 140, 5, 60, 22);
+    qualityLabel.setBounds (getWidth() - 370, 5, 225, 22);
+}
+
+void Project11AudioProcessorEditor::updateQualityLabel()
+{
+    auto level = audioProcessor.cpuGovernor.getLevel();
+    if (level == displayedQualityLevel)
+        return;
+    
+    displayedQualityLevel = level;
+    
+    //nothing to say at full quality
+    qualityLabel.setText (level == CpuGovernor::Full ? juce::String() : juce::String (CpuGovernor::getLevelName (level)),
+                          juce::dontSendNotification);
+}
+
+void Project11AudioProcessorEditor::chooseMatchFiles()
+{
+    auto patterns = juce::String ("*.wav;*.aif;*.aiff;*.flac;*.ogg;*.mp3");
+    auto flags = juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles;
+    
+    fileChooser = std::make_unique<juce::FileChooser> ("Reference to match", juce::File(), patterns);
+    fileChooser->launchAsync (flags, [this, patterns, flags] (const juce::FileChooser& referenceChooser)
+    {
+        referenceFile = referenceChooser.getResult();
+        if (referenceFile == juce::File())
+            return;
+        
+        fileChooser = std::make_unique<juce::FileChooser> ("Bounce of the mix", referenceFile.getParentDirectory(), patterns);
+        fileChooser->launchAsync (flags, [this] (const juce::FileChooser& mixChooser)
+        {
+            auto mixFile = mixChooser.getResult();
+            if (mixFile == juce::File())
+                return;
+            
+            auto started = matchEQ.start (referenceFile, mixFile, [this] (const MatchEQ::Result& result)
+            {
+                matchButton.setEnabled (true);
+                
+                if (! result.ok)
+                {
+                    juce::AlertWindow::showMessageBoxAsync (juce::MessageBoxIconType::WarningIcon, "Match EQ", result.error);
+                    return;
+                }
+                
+                DBG ("Match EQ: " << FilterInfo::filterToString (result.type) << " " << result.frequency << "Hz Q " << result.quality
+                     << " " << result.gainInDecibels << "dB, " << result.residualDb << "dB left over, "
+                     << result.analysisSeconds << "s");
+            });
+            
+            matchButton.setEnabled (! started);
+        });
+    });
 }
@@ -10,6 +10,8 @@
 
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
+#include "ResponseCurveComponent.h"
+#include "MatchEQ.h"
 
 //==============================================================================
 /**
@@ -28,6 +30,25 @@ private:
     // This reference is provided as a quick way for your editor to
     // access the processor object that created it.
     Project11AudioProcessor& audioProcessor;
+    
+    ResponseCurveComponent responseCurveComponent;
+    
+    //on: record, off: write what was recorded to a Chrome trace JSON in the documents folder. See Trace.h
+    juce::TextButton traceButton {"Trace"};
+    
+    //asks for a reference and a bounce of the mix, then sets the band to make one sound like the other. See MatchEQ.h
+    juce::TextButton matchButton {"Match"};
+    std::unique_ptr<juce::FileChooser> fileChooser;
+    juce::File referenceFile;
+    MatchEQ matchEQ;
+    void chooseMatchFiles();
+    
+    //what the CPU governor has switched off, checked once per frame
+    juce::Label qualityLabel;
+    int displayedQualityLevel {-1};
+    void updateQualityLabel();
+    
+    juce::VBlankAttachment vBlankAttachment {this, [this] { updateQualityLabel(); }};
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Project11AudioProcessorEditor)
 };
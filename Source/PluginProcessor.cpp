@@ -8,6 +8,7 @@
 
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "Trace.h"
 
 
 
@@ -44,59 +45,300 @@ juce::String generateBypassParamString(int filterNum)
     return ParamString("bypass",filterNum);
 }
 
+juce::String generateSlopeParamString(int filterNum)
+{
+    return ParamString("slope",filterNum);
+}
+
+juce::String generateResponseParamString(int filterNum)
+{
+    return ParamString("response",filterNum);
+}
+
+juce::String generateDesignParamString(int filterNum)
+{
+    return ParamString("design",filterNum);
+}
+
+juce::String generateDynamicParamString(int filterNum)
+{
+    return ParamString("dynamic",filterNum);
+}
+
+juce::String generateThresholdParamString(int filterNum)
+{
+    return ParamString("threshold",filterNum);
+}
+
+juce::String generateRatioParamString(int filterNum)
+{
+    return ParamString("ratio",filterNum);
+}
+
+juce::String generateAttackParamString(int filterNum)
+{
+    return ParamString("attack",filterNum);
+}
+
+juce::String generateReleaseParamString(int filterNum)
+{
+    return ParamString("release",filterNum);
+}
+
+juce::String generateSidechainParamString(int filterNum)
+{
+    return ParamString("sidechain",filterNum);
+}
+
+juce::String generateAutoGainParamString()
+{
+    return "AutoGain";
+}
+
+juce::String generateCrossoverEnabledParamString()
+{
+    return "Crossover_enabled";
+}
+
+juce::String generateNumBandsParamString()
+{
+    return "Crossover_bands";
+}
+
+juce::String generateCrossoverFreqParamString(int crossoverNum)
+{
+    return "Crossover_" + juce::String(crossoverNum) + "_freq";
+}
+
+juce::String generateBandGainParamString(int bandNum)
+{
+    return "Band_" + juce::String(bandNum) + "_gain";
+}
+
+juce::String generateBandMuteParamString(int bandNum)
+{
+    return "Band_" + juce::String(bandNum) + "_mute";
+}
+
+juce::String generateBandSoloParamString(int bandNum)
+{
+    return "Band_" + juce::String(bandNum) + "_solo";
+}
+
+juce::String generateCpuBudgetParamString()
+{
+    return "CPU_budget";
+}
+
 //==============================================================================
 
 
 void Project11AudioProcessor::updateFilterParams()
 {
+    Trace::Scope scope {"updateFilterParams"};
+    
     using namespace FilterInfo;
     
-    float freq = apvts.getRawParameterValue(generateFreqParamString(0))->load();
-    float q = apvts.getRawParameterValue(generateQParamString(0))->load();
-    float gain = apvts.getRawParameterValue(generateGainParamString(0))->load();
-    auto type = apvts.getRawParameterValue(generateTypeParamString(0))->load();
-    auto bypass = apvts.getRawParameterValue(generateBypassParamString(0))->load() > 0.5f;
+    auto& state = *dsp;
+    
+    float freq = parameterValues.freq->load();
+    float q = parameterValues.quality->load();
+    float gain = parameterValues.gain->load();
+    auto type = static_cast<int>(parameterValues.type->load());
+    auto bypass = parameterValues.bypass->load() > 0.5f;
+    
+    auto typeChanged = type != state.existingType;
+    
+    //cut types run through cutFilter, the rest through the chains. Whichever we're switching to last ran with
+    //another setting (or never), its leftover state would click.
+    auto isCutType = [] (int t) { return t == LowPass || t == HighPass; };
+    if (typeChanged && isCutType(type) != isCutType(state.existingType))
+    {
+        if (isCutType(type))
+        {
+            state.cutFilter.reset();
+        }
+        else
+        {
+            state.leftChain.reset();
+            state.rightChain.reset();
+        }
+    }
+    
+    state.existingType = type;
 
 
     if ( type == LowPass || type == HighPass )
     {
+        //slope choices are 6, 12 ... 96 dB/Oct, so the index is the order minus one
+        auto slope = static_cast<int>(parameterValues.slope->load());
+        auto response = static_cast<int>(parameterValues.response->load());
+        
         HighCutLowCutParameters highLow;
+        highLow.isLowcut = (type == HighPass);
         highLow.frequency = freq;
         highLow.quality = q;
         highLow.bypassed = bypass;
+        highLow.sampleRate = getSampleRate();
+        highLow.order = slope + 1;
+        highLow.response = static_cast<SlopeDesign::Response>(response);
+        
+        state.dynamicBandActive = false;
         
-        if (!( highLow == existingHighLow ))
+        if (typeChanged || !( highLow == state.existingHighLow ))
         {
-            auto chainCoefficients = makeCoefficients(highLow);
-            
-            *(leftChain.get<0>().coefficients) = *(chainCoefficients[0]);
-            *(rightChain.get<0>().coefficients) = *(chainCoefficients[0]);
-            
-            leftChain.setBypassed<0>(bypass);
-            rightChain.setBypassed<0>(bypass);
+            makeCoefficients(highLow, state.cutSections);
+            state.cutFilter.setSections(state.cutSections);
             
+            state.autoGain.setResponse(state.cutSections.sections.data(), bypass ? 0 : state.cutSections.numSections);
         }
-        existingHighLow = highLow;
+        state.cutFilterActive = !bypass;
+        state.existingHighLow = highLow;
 
     }
     else
     {
         FilterParameters filterParams;
+        filterParams.filterType = static_cast<FilterType>(type);
         filterParams.frequency = freq;
         filterParams.quality = q;
         filterParams.gainInDecibels = gain;
+        filterParams.analogMatched = parameterValues.design->load() > 0.5f;
         filterParams.bypassed = bypass;
-        if (!( filterParams == existingFilterParams ))
+        filterParams.sampleRate = getSampleRate();
+        state.cutFilterActive = false;
+        
+        /*A new pick is a change like any other and redesigns the band, so until it lands (within a few blocks) the band
+         runs the last method picked.*/
+        auto isPeakOrShelf = (type == Peak || type == LowShelf || type == HighShelf);
+        if (filterParams.analogMatched && isPeakOrShelf)
         {
+            MatchedDesign::MethodPicker::Settings pick;
+            pick.shape = type == Peak ? MatchedDesign::Peak : (type == LowShelf ? MatchedDesign::LowShelf : MatchedDesign::HighShelf);
+            pick.freq = freq;
+            pick.q = q;
+            pick.gainInDecibels = gain;
+            pick.sampleRate = filterParams.sampleRate;
+            
+            filterParams.matchedMethod = state.methodPicker.getMethod(pick);
+        }
+        
+        if (typeChanged || !( filterParams == state.existingFilterParams ))
+        {
+            Trace::Scope designScope {"makeCoefficients"};
+            
             auto chainCoefficients = makeCoefficients(filterParams);
-            *(leftChain.get<0>().coefficients) = *chainCoefficients;
-            *(rightChain.get<0>().coefficients) = *chainCoefficients;
+            *(state.leftChain.get<0>().coefficients) = *chainCoefficients;
+            *(state.rightChain.get<0>().coefficients) = *chainCoefficients;
             
-            leftChain.setBypassed<0>(bypass);
-            rightChain.setBypassed<0>(bypass);
+            state.leftChain.setBypassed<0>(bypass);
+            state.rightChain.setBypassed<0>(bypass);
+            
+            /*A dynamic band's static gain is in these coefficients, its gain reduction deliberately isn't: compensating
+             the reduction would turn the level straight back up and undo the compression.*/
+            state.autoGain.setResponse(*chainCoefficients, bypass);
+        }
+        state.existingFilterParams = filterParams;
+        
+        state.dynamicBandActive = isPeakOrShelf && !bypass && parameterValues.dynamic->load() > 0.5f;
+        
+        if (state.dynamicBandActive)
+        {
+            DynamicBand::Settings settings;
+            settings.shape = type == Peak ? DynamicBand::Peak : (type == LowShelf ? DynamicBand::LowShelf : DynamicBand::HighShelf);
+            settings.frequency = freq;
+            settings.quality = q;
+            settings.gainInDecibels = gain;
+            settings.analogMatched = filterParams.analogMatched;
+            settings.matchedMethod = filterParams.matchedMethod;
+            settings.thresholdInDecibels = parameterValues.threshold->load();
+            settings.ratio = parameterValues.ratio->load();
+            settings.attackMs = parameterValues.attack->load();
+            settings.releaseMs = parameterValues.release->load();
             
+            state.dynamicBand.setSettings(settings);
+        }
+    }
+}
+
+void Project11AudioProcessor::updateCrossoverParams()
+{
+    auto& crossover = dsp->crossover;
+    
+    auto numBands = static_cast<int>(parameterValues.numBands->load());
+    
+    std::array<float, Crossover::maxBands - 1> freqs;
+    for (size_t i = 0; i < freqs.size(); ++i)
+    {
+        freqs[i] = parameterValues.crossoverFreqs[i]->load();
+    }
+    
+    crossover.setCrossovers(numBands, freqs.data());
+    
+    //solo wins over mute: if anything is soloed only the soloed bands are heard
+    bool anySolo = false;
+    for (int band = 0; band < numBands; ++band)
+    {
+        anySolo = anySolo || parameterValues.bandSolos[static_cast<size_t>(band)]->load() > 0.5f;
+    }
+    
+    std::array<float, Crossover::maxBands> gains {};
+    for (int band = 0; band < numBands; ++band)
+    {
+        auto i = static_cast<size_t>(band);
+        auto muted = parameterValues.bandMutes[i]->load() > 0.5f;
+        auto soloed = parameterValues.bandSolos[i]->load() > 0.5f;
+        
+        if (anySolo ? soloed : !muted)
+        {
+            gains[i] = Decibel<float>(parameterValues.bandGains[i]->load()).getGain();
+        }
+    }
+    
+    crossover.setBandGains(gains.data());
+    
+    //only hands over when something changed
+    dsp->autoGain.setCrossover(crossover.getNumBands(), crossover.getCrossoverFrequencies(), gains.data());
+}
+
+void Project11AudioProcessor::applyQualityLevel(int level)
+{
+    //the analyzer levels halve the frames collected, the ones after them double the dynamic band's sub-block. See
+    //CpuGovernor.h for the order
+    const auto analyzerSteps = juce::jmin(level, static_cast<int>(CpuGovernor::QuarterRateAnalyzer));
+    const auto dynamicsSteps = level - analyzerSteps;
+    
+    analyzerFifo.setFrameStride(1 << analyzerSteps);
+    dsp->dynamicBand.setSubBlockSize(DynamicBand::defaultSubBlockSize << dynamicsSteps);
+}
+
+void Project11AudioProcessor::processBand(bool dynamic, juce::dsp::AudioBlock<float>& block, juce::AudioBuffer<float>& buffer)
+{
+    auto& state = *dsp;
+    
+    if (dynamic)
+    {
+        //the detector listens to the sidechain if there is one and it's asked for, otherwise to the dry input
+        if (parameterValues.sidechain->load() > 0.5f && getChannelCountOfBus(true, 1) > 0)
+        {
+            auto sidechainBuffer = getBusBuffer(buffer, true, 1);
+            state.dynamicBand.process(block, juce::dsp::AudioBlock<float>(sidechainBuffer).getSubBlock(0, block.getNumSamples()));
+        }
+        else
+        {
+            state.dynamicBand.process(block, block);
         }
-        existingFilterParams = filterParams;
+    }
+    else
+    {
+        auto leftBlock = block.getSingleChannelBlock(0);
+        auto rightBlock = block.getSingleChannelBlock(1);
+        
+        juce::dsp::ProcessContextReplacing<float> leftContext(leftBlock);
+        juce::dsp::ProcessContextReplacing<float> rightContext(rightBlock);
+        
+        state.leftChain.process(leftContext);
+        state.rightChain.process(rightContext);
     }
 }
 
@@ -107,12 +349,47 @@ Project11AudioProcessor::Project11AudioProcessor()
                      #if ! JucePlugin_IsMidiEffect
                       #if ! JucePlugin_IsSynth
                        .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
+                       .withInput  ("Sidechain", juce::AudioChannelSet::stereo(), false)
                       #endif
                        .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
                      #endif
                        )
 #endif
 {
+    parameterValues.freq = apvts.getRawParameterValue(generateFreqParamString(0));
+    parameterValues.quality = apvts.getRawParameterValue(generateQParamString(0));
+    parameterValues.gain = apvts.getRawParameterValue(generateGainParamString(0));
+    parameterValues.type = apvts.getRawParameterValue(generateTypeParamString(0));
+    parameterValues.bypass = apvts.getRawParameterValue(generateBypassParamString(0));
+    parameterValues.slope = apvts.getRawParameterValue(generateSlopeParamString(0));
+    parameterValues.response = apvts.getRawParameterValue(generateResponseParamString(0));
+    parameterValues.design = apvts.getRawParameterValue(generateDesignParamString(0));
+    parameterValues.dynamic = apvts.getRawParameterValue(generateDynamicParamString(0));
+    parameterValues.threshold = apvts.getRawParameterValue(generateThresholdParamString(0));
+    parameterValues.ratio = apvts.getRawParameterValue(generateRatioParamString(0));
+    parameterValues.attack = apvts.getRawParameterValue(generateAttackParamString(0));
+    parameterValues.release = apvts.getRawParameterValue(generateReleaseParamString(0));
+    parameterValues.sidechain = apvts.getRawParameterValue(generateSidechainParamString(0));
+    parameterValues.autoGain = apvts.getRawParameterValue(generateAutoGainParamString());
+    
+    parameterValues.crossoverEnabled = apvts.getRawParameterValue(generateCrossoverEnabledParamString());
+    parameterValues.numBands = apvts.getRawParameterValue(generateNumBandsParamString());
+    for (int i = 0; i < Crossover::maxBands - 1; ++i)
+    {
+        parameterValues.crossoverFreqs[static_cast<size_t>(i)] = apvts.getRawParameterValue(generateCrossoverFreqParamString(i));
+    }
+    for (int i = 0; i < Crossover::maxBands; ++i)
+    {
+        parameterValues.bandGains[static_cast<size_t>(i)] = apvts.getRawParameterValue(generateBandGainParamString(i));
+        parameterValues.bandMutes[static_cast<size_t>(i)] = apvts.getRawParameterValue(generateBandMuteParamString(i));
+        parameterValues.bandSolos[static_cast<size_t>(i)] = apvts.getRawParameterValue(generateBandSoloParamString(i));
+    }
+    
+    parameterValues.cpuBudget = apvts.getRawParameterValue(generateCpuBudgetParamString());
+    
+   #if PROJECT11_EAGER_INSTANTIATION
+    dsp = std::make_unique<DspState>();
+   #endif
 }
 
 Project11AudioProcessor::~Project11AudioProcessor()
@@ -123,7 +400,35 @@ Project11AudioProcessor::~Project11AudioProcessor()
 
 juce::AudioProcessorValueTreeState::ParameterLayout Project11AudioProcessor::createParameterLayout()
 {
-//    const auto& params = FilterInfo::GetParams();
+    /*The layout itself has to exist as soon as we're constructed, hosts read the parameters straight away.
+     The choice lists are the same for every instance though, so they're built once per process and shared.*/
+   #if PROJECT11_EAGER_INSTANTIATION
+    juce::StringArray types;
+    for (const auto& [name, stringRep] : FilterInfo::filterToStringMap)
+    {
+        types.add(stringRep);
+    }
+    juce::StringArray designs {"Bilinear", "Analog matched"};
+    juce::StringArray responses {"Butterworth", "Linkwitz-Riley", "Bessel", "Chebyshev"};
+    juce::StringArray slopes;
+    for (int order = 1; order <= SlopeDesign::maxOrder; ++order)
+    {
+        slopes.add(juce::String(order * 6) + " dB/Oct");
+    }
+   #else
+    static const juce::StringArray types (FilterInfo::filterNames.data(), FilterInfo::numFilterTypes);
+    static const juce::StringArray designs {"Bilinear", "Analog matched"};
+    static const juce::StringArray responses (SlopeDesign::responseNames.data(), static_cast<int>(SlopeDesign::responseNames.size()));
+    static const juce::StringArray slopes = []
+    {
+        juce::StringArray names;
+        for (int order = 1; order <= SlopeDesign::maxOrder; ++order)
+        {
+            names.add(juce::String(order * 6) + " dB/Oct");
+        }
+        return names;
+    }();
+   #endif
     
     juce::AudioProcessorValueTreeState::ParameterLayout layout;
     
@@ -151,21 +456,6 @@ juce::AudioProcessorValueTreeState::ParameterLayout Project11AudioProcessor::cre
                                                            juce::NormalisableRange<float>(20.f, 20000.f, 1.f, 1.f),
                                                            20.f));
     
-    juce::StringArray types;
-    
-    for (const auto& [name, stringRep] : FilterInfo::filterToString)
-    {
-       types.add(stringRep);
-    }
-    
-    
-//    //Alternative
-//    for ( const auto& elem : FilterInfo::filterToString )
-//    {
-//        types.add(elem.second);
-//    }
-
-    
     layout.add(std::make_unique<juce::AudioParameterChoice>(
                                                             juce::ParameterID(
                                                             generateTypeParamString(0), 1),
@@ -173,6 +463,114 @@ juce::AudioProcessorValueTreeState::ParameterLayout Project11AudioProcessor::cre
                                                             types,
                                                             0));
     
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+                                                            juce::ParameterID(generateSlopeParamString(0), 1),
+                                                            generateSlopeParamString(0),
+                                                            slopes,
+                                                            1));
+    
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+                                                            juce::ParameterID(generateResponseParamString(0), 1),
+                                                            generateResponseParamString(0),
+                                                            responses,
+                                                            0));
+    
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+                                                            juce::ParameterID(generateDesignParamString(0), 1),
+                                                            generateDesignParamString(0),
+                                                            designs,
+                                                            0));
+    
+    layout.add(std::make_unique<juce::AudioParameterBool>(
+                                                          juce::ParameterID(generateDynamicParamString(0), 1),
+                                                          generateDynamicParamString(0),
+                                                          false));
+    
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+                                                           juce::ParameterID(generateThresholdParamString(0), 1),
+                                                           generateThresholdParamString(0),
+                                                           juce::NormalisableRange<float>(-60.f, 0.f, 0.1f, 1.f),
+                                                           -20.f));
+    
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+                                                           juce::ParameterID(generateRatioParamString(0), 1),
+                                                           generateRatioParamString(0),
+                                                           juce::NormalisableRange<float>(1.f, 20.f, 0.1f, 0.5f),
+                                                           2.f));
+    
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+                                                           juce::ParameterID(generateAttackParamString(0), 1),
+                                                           generateAttackParamString(0),
+                                                           juce::NormalisableRange<float>(0.1f, 200.f, 0.1f, 0.4f),
+                                                           5.f));
+    
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+                                                           juce::ParameterID(generateReleaseParamString(0), 1),
+                                                           generateReleaseParamString(0),
+                                                           juce::NormalisableRange<float>(5.f, 2000.f, 1.f, 0.4f),
+                                                           100.f));
+    
+    layout.add(std::make_unique<juce::AudioParameterBool>(
+                                                          juce::ParameterID(generateSidechainParamString(0), 1),
+                                                          generateSidechainParamString(0),
+                                                          false));
+    
+    layout.add(std::make_unique<juce::AudioParameterBool>(
+                                                          juce::ParameterID(generateAutoGainParamString(), 1),
+                                                          generateAutoGainParamString(),
+                                                          false));
+    
+    layout.add(std::make_unique<juce::AudioParameterBool>(
+                                                          juce::ParameterID(generateCrossoverEnabledParamString(), 1),
+                                                          generateCrossoverEnabledParamString(),
+                                                          false));
+    
+    layout.add(std::make_unique<juce::AudioParameterInt>(
+                                                         juce::ParameterID(generateNumBandsParamString(), 1),
+                                                         generateNumBandsParamString(),
+                                                         Crossover::minBands,
+                                                         Crossover::maxBands,
+                                                         3));
+    
+    const std::array<float, Crossover::maxBands - 1> defaultCrossovers { 100.f, 500.f, 2000.f, 5000.f, 10000.f };
+    for (int i = 0; i < Crossover::maxBands - 1; ++i)
+    {
+        layout.add(std::make_unique<juce::AudioParameterFloat>(
+                                                               juce::ParameterID(generateCrossoverFreqParamString(i), 1),
+                                                               generateCrossoverFreqParamString(i),
+                                                               juce::NormalisableRange<float>(20.f, 20000.f, 1.f, 0.25f),
+                                                               defaultCrossovers[static_cast<size_t>(i)]));
+    }
+    
+    for (int i = 0; i < Crossover::maxBands; ++i)
+    {
+        layout.add(std::make_unique<juce::AudioParameterFloat>(
+                                                               juce::ParameterID(generateBandGainParamString(i), 1),
+                                                               generateBandGainParamString(i),
+                                                               juce::NormalisableRange<float>(-24.f, 24.f, 0.1f, 1.f),
+                                                               0.f));
+        
+        layout.add(std::make_unique<juce::AudioParameterBool>(
+                                                              juce::ParameterID(generateBandMuteParamString(i), 1),
+                                                              generateBandMuteParamString(i),
+                                                              false));
+        
+        layout.add(std::make_unique<juce::AudioParameterBool>(
+                                                              juce::ParameterID(generateBandSoloParamString(i), 1),
+                                                              generateBandSoloParamString(i),
+                                                              false));
+    }
+    
+    //share of each block this instance may use before the CPU governor steps work down, in percent. A setting for the
+    //session, not something to automate.
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+                                                           juce::ParameterID(generateCpuBudgetParamString(), 1),
+                                                           generateCpuBudgetParamString(),
+                                                           juce::NormalisableRange<float>(5.f, 100.f, 1.f, 1.f),
+                                                           25.f,
+                                                           juce::AudioParameterFloatAttributes().withAutomatable(false)
+                                                                                                 .withLabel("%")));
+    
     return layout;
 }
 
@@ -251,14 +649,45 @@ void Project11AudioProcessor::prepareToPlay (double sampleRate, int samplesPerBl
     spec.maximumBlockSize = samplesPerBlock;
     spec.numChannels = getTotalNumOutputChannels();
     
-    leftChain.prepare(spec);
-    rightChain.prepare(spec);
+    if (dsp == nullptr)
+    {
+        dsp = std::make_unique<DspState>();
+    }
+    
+    dsp->leftChain.prepare(spec);
+    dsp->rightChain.prepare(spec);
+    
+    dsp->cutFilter.prepare(juce::jmin(CascadeFilter::maxChannels, getTotalNumOutputChannels()));
+    
+    dsp->dynamicBand.prepare(sampleRate, juce::jmin(CascadeFilter::maxChannels, getTotalNumOutputChannels()));
+    
+    dsp->dynamicCrossfadeLength = juce::jmax(1, juce::roundToInt(sampleRate * DspState::dynamicCrossfadeMs * 0.001));
+    dsp->dynamicCrossfadeRemaining = 0;
+    dsp->crossfadeBuffer.setSize(getTotalNumOutputChannels(), dsp->dynamicCrossfadeLength);
+    
+    dsp->crossover.prepare(sampleRate, juce::jmin(Crossover::maxChannels, getTotalNumOutputChannels()));
+    
+    dsp->outputGain.prepare(spec);
+    dsp->outputGain.setRampDurationSeconds(0.05);
+    
+    analyzerFifo.prepare(1 << analyzerFftOrder);
+    
+    cpuGovernor.prepare(sampleRate);
+    applyQualityLevel(cpuGovernor.getLevel());
+    
+    //the chains were just reset, make sure the next block redesigns and re-publishes the response
+    dsp->existingType = -1;
+    dsp->autoGain.prepare(sampleRate);
 }
 
 void Project11AudioProcessor::releaseResources()
 {
     // When playback stops, you can use this as an opportunity to free up any
     // spare memory, etc.
+    if (dsp != nullptr)
+    {
+        dsp->autoGain.release();
+    }
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -280,6 +709,16 @@ bool Project11AudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts
    #if ! JucePlugin_IsSynth
     if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
         return false;
+    
+    //the sidechain only feeds the dynamic band's detector, off, mono or stereo are all fine
+    if (layouts.inputBuses.size() > 1)
+    {
+        auto sidechain = layouts.getChannelSet(true, 1);
+        if ( ! sidechain.isDisabled()
+            && sidechain != juce::AudioChannelSet::mono()
+            && sidechain != juce::AudioChannelSet::stereo())
+            return false;
+    }
    #endif
 
     return true;
@@ -302,6 +741,15 @@ void Project11AudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, ju
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
     
+    //hosts shouldn't call us before prepareToPlay, but some do
+    if (dsp == nullptr)
+        return;
+    
+    Trace::setThreadName("Audio");
+    Trace::Scope scope {"processBlock"};
+    
+    cpuGovernor.blockStarted();
+    
     /*
      TO DO
      UpdateFilters() Function:
@@ -315,29 +763,128 @@ void Project11AudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, ju
      5. update leftChain and rightChain coefficients (leftChain.get<0>().coefficients = *coefficients)
      */
     
-//    const auto& params = FilterInfo::GetParams();
     using namespace FilterInfo;
     
     updateFilterParams();
     
-    juce::dsp::AudioBlock<float> block(buffer);
+    auto& state = *dsp;
+    
+    //the governor sheds analyzer work first, then dynamic band work; whatever it decided after the last block takes
+    //effect here, before anything is processed
+    cpuGovernor.setBudget(parameterValues.cpuBudget->load() * 0.01f);
+    if (state.dynamicBandActive)
+    {
+        cpuGovernor.setDeepestLevel(CpuGovernor::QuarterRateDynamics);
+    }
+    else
+    {
+        cpuGovernor.setDeepestLevel(analyzerEnabled.load(std::memory_order_relaxed) ? CpuGovernor::QuarterRateAnalyzer
+                                                                                     : CpuGovernor::Full);
+    }
+    applyQualityLevel(cpuGovernor.getLevel());
+    
+    //buffer also carries the sidechain channels, everything below only touches the main bus
+    auto mainBuffer = getBusBuffer(buffer, false, 0);
+    juce::dsp::AudioBlock<float> block(mainBuffer);
+    
+    if (state.existingType == LowPass || state.existingType == HighPass)
+    {
+        //one fused pass over every section and both channels, see CascadeFilter.h
+        if (state.cutFilterActive)
+        {
+            state.cutFilter.process(block);
+        }
+        
+        //switching back to a Peak or shelf resets the chains, see updateFilterParams()
+        state.dynamicBandWasActive = false;
+        state.dynamicCrossfadeRemaining = 0;
+    }
+    else
+    {
+        if (state.dynamicBandActive != state.dynamicBandWasActive)
+        {
+            if (state.dynamicBandActive)
+            {
+                state.dynamicBand.reset();
+            }
+            else
+            {
+                state.leftChain.reset();
+                state.rightChain.reset();
+            }
+            
+            state.dynamicBandWasActive = state.dynamicBandActive;
+            state.dynamicCrossfadeRemaining = state.dynamicCrossfadeLength;
+        }
+        
+        const auto numSamples = static_cast<int>(block.getNumSamples());
+        const auto fadeSamples = juce::jmin(state.dynamicCrossfadeRemaining, numSamples);
+        
+        //the path being left runs on a copy of the start of the block, for as much of the fade as falls in it
+        auto leaving = juce::dsp::AudioBlock<float>(state.crossfadeBuffer).getSubsetChannelBlock(0, block.getNumChannels())
+                                                                         .getSubBlock(0, static_cast<size_t>(fadeSamples));
+        if (fadeSamples > 0)
+        {
+            leaving.copyFrom(block.getSubBlock(0, static_cast<size_t>(fadeSamples)));
+            processBand(!state.dynamicBandActive, leaving, buffer);
+        }
+        
+        processBand(state.dynamicBandActive, block, buffer);
+        
+        if (fadeSamples > 0)
+        {
+            const auto faded = state.dynamicCrossfadeLength - state.dynamicCrossfadeRemaining;
+            const auto step = 1.f / static_cast<float>(state.dynamicCrossfadeLength);
+            
+            for (size_t channel = 0; channel < block.getNumChannels(); ++channel)
+            {
+                auto* entering = block.getChannelPointer(channel);
+                const auto* left = leaving.getChannelPointer(channel);
+                
+                for (int i = 0; i < fadeSamples; ++i)
+                {
+                    auto weight = static_cast<float>(faded + i + 1) * step;
+                    entering[i] = left[i] + weight * (entering[i] - left[i]);
+                }
+            }
+            
+            state.dynamicCrossfadeRemaining -= fadeSamples;
+        }
+    }
     
-    auto leftBlock = block.getSingleChannelBlock(0);
-    auto rightBlock = block.getSingleChannelBlock(1);
+    //all bands in one pass, see Crossover.h. Off, it costs nothing.
+    if (parameterValues.crossoverEnabled->load() > 0.5f)
+    {
+        updateCrossoverParams();
+        state.crossover.process(block);
+    }
+    else
+    {
+        state.autoGain.setCrossover(0, nullptr, nullptr);
+    }
     
-    juce::dsp::ProcessContextReplacing<float> leftContext(leftBlock);
-    juce::dsp::ProcessContextReplacing<float> rightContext(rightBlock);
+    /*Auto gain: the loudness change was worked out on the AutoGain thread from the coefficients, all that's left
+     here is a smoothed gain stage.*/
+    state.autoGain.publishPending();
     
-    leftChain.process(leftContext);
-    rightChain.process(rightContext);
+    Decibel<float> compensation;
+    if (parameterValues.autoGain->load() > 0.5f)
+    {
+        compensation.setDb(-state.autoGain.getLoudnessChangeDb());
+    }
     
+    state.outputGain.setGainLinear(compensation.getGain());
     
+    juce::dsp::ProcessContextReplacing<float> context(block);
+    state.outputGain.process(context);
     
-//    Accessing map examples:
-//    float freq = apvts.getRawParameterValue(params.at(FirstOrderLowPass))->load();
-//    float freq = apvts.getRawParameterValue("FirstOrderLowPass")->load();
-//    float freq = apvts.getRawParameterValue(filterToString.at(FirstOrderLowPass))->load();
+    if (analyzerEnabled.load(std::memory_order_relaxed) && analyzerFifo.isPrepared())
+    {
+        analyzerFifo.update(mainBuffer);
+    }
     
+    cpuGovernor.blockFinished(buffer.getNumSamples());
+
 }
 
 //==============================================================================
@@ -348,8 +895,8 @@ bool Project11AudioProcessor::hasEditor() const
 
 juce::AudioProcessorEditor* Project11AudioProcessor::createEditor()
 {
-//    return new Project11AudioProcessorEditor (*this);
-    return new juce::GenericAudioProcessorEditor(*this);
+    return new Project11AudioProcessorEditor (*this);
+//    return new juce::GenericAudioProcessorEditor(*this);
 }
 
 //==============================================================================
@@ -358,6 +905,8 @@ void Project11AudioProcessor::getStateInformation (juce::MemoryBlock& destData)
     // You should use this method to store your parameters in the memory block.
     // You could do that either as raw data, or use the XML or ValueTree classes
     // as intermediaries to make it easy to save and load complex data.
+    Trace::Scope scope {"getStateInformation"};
+    
     copyXmlToBinary(*apvts.copyState().createXml(), destData);
 }
 
@@ -365,6 +914,8 @@ void Project11AudioProcessor::setStateInformation (const void* data, int sizeInB
 {
     // You should use this method to restore your parameters from this memory block,
     // whose contents will have been created by the getStateInformation() call.
+    Trace::Scope scope {"setStateInformation"};
+    
     std::unique_ptr<juce::XmlElement> xml(getXmlFromBinary(data, sizeInBytes));
     if ( xml.get() != nullptr && xml->hasTagName(apvts.state.getType()))
     {
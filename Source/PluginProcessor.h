@@ -9,6 +9,22 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "Fifo.h"
+#include "Decibel.h"
+#include "AutoGain.h"
+#include "SlopeDesign.h"
+#include "CascadeFilter.h"
+#include "MatchedDesign.h"
+#include "Crossover.h"
+#include "DynamicBand.h"
+#include "CpuGovernor.h"
+
+/*Set to 1 to instantiate the way this plugin did before the constexpr tables and the lazy DSP state: a std::map per
+ translation unit, the choice lists rebuilt for every instance and every DSP object built in the constructor. Only
+ there so a host scan can be measured before and after, see HostSimulation::runScan().*/
+#ifndef PROJECT11_EAGER_INSTANTIATION
+ #define PROJECT11_EAGER_INSTANTIATION 0
+#endif
 
 //==============================================================================
 
@@ -34,27 +50,33 @@ enum FilterType
     Peak
 };
 
-inline const std::map<FilterInfo::FilterType, juce::String>& GetParams()
+static constexpr int numFilterTypes = Peak + 1;
+
+/*Indexed by FilterType, in the same order as the choices of the type parameter.
+ Being constexpr, every translation unit shares one read-only table instead of building its own std::map during static initialisation.*/
+inline constexpr std::array<const char*, numFilterTypes> filterNames
 {
-    static std::map<FilterInfo::FilterType, juce::String> params =
-    {
-        {FirstOrderLowPass, "FirstOrder LowPass"},
-        {FirstOrderHighPass, "FirstOrder HighPass"},
-        {FirstOrderAllPass, "FirstOrder AllPass"},
-        {LowPass, "LowPass"},
-        {HighPass, "HighPass"},
-        {BandPass, "BandPass"},
-        {Notch, "Notch"},
-        {AllPass, "Allpass"},
-        {LowShelf, "LowShelf"},
-        {HighShelf, "HighShelf"},
-        {Peak, "Peak"}
-    };
+    "FirstOrder LowPass",
+    "FirstOrder HighPass",
+    "FirstOrder AllPass",
+    "LowPass",
+    "HighPass",
+    "BandPass",
+    "Notch",
+    "Allpass",
+    "LowShelf",
+    "HighShelf",
+    "Peak"
+};
 
-    return params;
+constexpr const char* filterToString(FilterType type)
+{
+    return filterNames[static_cast<size_t>(type)];
 }
 
-const std::map<FilterType, juce::String> filterToString
+#if PROJECT11_EAGER_INSTANTIATION
+//the tables as they were, one std::map per translation unit built during static initialisation
+const std::map<FilterType, juce::String> filterToStringMap
     {
         {FirstOrderLowPass, "FirstOrder LowPass"},
         {FirstOrderHighPass, "FirstOrder HighPass"},
@@ -68,6 +90,8 @@ const std::map<FilterType, juce::String> filterToString
         {HighShelf, "HighShelf"},
         {Peak, "Peak"}
     };
+#endif
+
 } //end namespace FilterInfo
 
 //==============================================================================
@@ -83,19 +107,25 @@ struct FilterParametersBase
 
 inline bool operator==(const FilterParametersBase& lhs, const FilterParametersBase& rhs)
 {
-    return ( lhs.frequency == rhs.frequency && lhs.quality == rhs.quality );
+    return ( lhs.frequency == rhs.frequency && lhs.quality == rhs.quality &&
+             lhs.bypassed == rhs.bypassed && lhs.sampleRate == rhs.sampleRate );
 }
 
 struct FilterParameters : public FilterParametersBase
 {
     FilterInfo::FilterType filterType {FilterInfo::FilterType::LowPass};
     float gainInDecibels {0.0f};
+    //Peak and shelves only: analog matched instead of bilinear, see MatchedDesign.h
+    bool analogMatched {false};
+    //picked off the audio thread by a MatchedDesign::MethodPicker
+    MatchedDesign::Method matchedMethod {MatchedDesign::ThreePointFit};
     
 };
 
 inline bool operator==(const FilterParameters& lhs, const FilterParameters& rhs)
 {
-    return (lhs.frequency == rhs.frequency && lhs.quality == rhs.quality &&
+    return (lhs.filterType == rhs.filterType && lhs.gainInDecibels == rhs.gainInDecibels && lhs.analogMatched == rhs.analogMatched &&
+            lhs.matchedMethod == rhs.matchedMethod &&
             static_cast<FilterParametersBase>(lhs) == static_cast<FilterParametersBase>(rhs) );
 }
 
@@ -103,12 +133,14 @@ struct HighCutLowCutParameters : public FilterParametersBase
 {
     int order {1};
     bool isLowcut {true};
+    SlopeDesign::Response response {SlopeDesign::Butterworth};
     
 };
 
 inline bool operator==(const HighCutLowCutParameters& lhs, const HighCutLowCutParameters& rhs)
 {
-    return (lhs.order == rhs.order && lhs.isLowcut == rhs.isLowcut && static_cast<FilterParametersBase>(lhs) == static_cast<FilterParametersBase>(rhs) );
+    return (lhs.order == rhs.order && lhs.isLowcut == rhs.isLowcut && lhs.response == rhs.response &&
+            static_cast<FilterParametersBase>(lhs) == static_cast<FilterParametersBase>(rhs) );
 }
 
 
@@ -116,10 +148,26 @@ inline bool operator==(const HighCutLowCutParameters& lhs, const HighCutLowCutPa
 //==============================================================================
 
 
-static auto makeCoefficients(FilterInfo::FilterType type, float freq, float q, float gain, float sampleRate)
+/*matchedMethod is only used when analogMatched; it's whichever MatchedDesign::pickMethod() chose for these settings,
+ picked ahead of time because picking is far too slow to do here.*/
+static auto makeCoefficients(FilterInfo::FilterType type, float freq, float q, float gain, float sampleRate, bool analogMatched = false,
+                             MatchedDesign::Method matchedMethod = MatchedDesign::ThreePointFit)
 {
     using namespace FilterInfo;
     
+    //gain comes in as decibels, the juce factories want a gain factor
+    auto gainFactor = Decibel<float>(gain).getGain();
+    
+    //no cramping near Nyquist, see MatchedDesign.h
+    if (analogMatched && (type == FilterType::Peak || type == FilterType::LowShelf || type == FilterType::HighShelf))
+    {
+        auto shape = type == FilterType::Peak ? MatchedDesign::Peak : (type == FilterType::LowShelf ? MatchedDesign::LowShelf : MatchedDesign::HighShelf);
+        auto section = MatchedDesign::design(shape, freq, q, gain, sampleRate, matchedMethod);
+        
+        return juce::dsp::IIR::Coefficients<float>::Ptr(new juce::dsp::IIR::Coefficients<float>(section.b0, section.b1, section.b2,
+                                                                                              1.f, section.a1, section.a2));
+    }
+    
     switch (type) {
         case FilterType::FirstOrderLowPass:
                 return juce::dsp::IIR::Coefficients<float>::makeFirstOrderLowPass(sampleRate, freq);
@@ -138,33 +186,29 @@ static auto makeCoefficients(FilterInfo::FilterType type, float freq, float q, f
         case FilterType::AllPass:
             return juce::dsp::IIR::Coefficients<float>::makeAllPass(sampleRate, freq);
         case FilterType::LowShelf:
-            return juce::dsp::IIR::Coefficients<float>::makeLowShelf(sampleRate, freq, q, gain);
+            return juce::dsp::IIR::Coefficients<float>::makeLowShelf(sampleRate, freq, q, gainFactor);
         case FilterType::HighShelf:
-            return juce::dsp::IIR::Coefficients<float>::makeHighShelf(sampleRate, freq, q, gain);
+            return juce::dsp::IIR::Coefficients<float>::makeHighShelf(sampleRate, freq, q, gainFactor);
         case FilterType::Peak:
-            return juce::dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate, freq, q, gain);
+            return juce::dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate, freq, q, gainFactor);
     }
 }
 
 static auto makeCoefficients(FilterParameters filterParams)
 {
-    return makeCoefficients(filterParams.filterType, filterParams.frequency, filterParams.quality, filterParams.gainInDecibels, filterParams.sampleRate);
+    return makeCoefficients(filterParams.filterType, filterParams.frequency, filterParams.quality, filterParams.gainInDecibels, filterParams.sampleRate,
+                            filterParams.analogMatched, filterParams.matchedMethod);
 }
 
 
 /*
- For info on these see: JUCE/modules/juce_dsp/filter_design/juce_FilterDesign.h
+ The whole cascade, one second order section per pole pair, written into fixed storage so this never allocates.
+ For info on the designs see: SlopeDesign.h
  */
-static auto makeCoefficients(HighCutLowCutParameters highLowParams)
+static void makeCoefficients(const HighCutLowCutParameters& highLowParams, SlopeDesign::Sections& sections)
 {
-    if (highLowParams.isLowcut)
-    {
-        return juce::dsp::FilterDesign<float>::designIIRHighpassHighOrderButterworthMethod (highLowParams.frequency, highLowParams.sampleRate, highLowParams.order);
-    }
-    else
-    {
-        return juce::dsp::FilterDesign<float>::designIIRLowpassHighOrderButterworthMethod (highLowParams.frequency, highLowParams.sampleRate, highLowParams.order);
-    }
+    SlopeDesign::design(highLowParams.response, highLowParams.isLowcut, highLowParams.order,
+                        highLowParams.frequency, highLowParams.sampleRate, sections);
 }
 
 
@@ -183,10 +227,44 @@ juce::String generateQParamString(int filterNum);
 
 juce::String generateFreqParamString(int filterNum);
 
-juce::String generateFilterTypeString(int filterNum);
+juce::String generateTypeParamString(int filterNum);
 
 juce::String generateBypassParamString(int filterNum);
 
+juce::String generateSlopeParamString(int filterNum);
+
+juce::String generateResponseParamString(int filterNum);
+
+juce::String generateDesignParamString(int filterNum);
+
+juce::String generateDynamicParamString(int filterNum);
+
+juce::String generateThresholdParamString(int filterNum);
+
+juce::String generateRatioParamString(int filterNum);
+
+juce::String generateAttackParamString(int filterNum);
+
+juce::String generateReleaseParamString(int filterNum);
+
+juce::String generateSidechainParamString(int filterNum);
+
+juce::String generateAutoGainParamString();
+
+juce::String generateCrossoverEnabledParamString();
+
+juce::String generateNumBandsParamString();
+
+juce::String generateCrossoverFreqParamString(int crossoverNum);
+
+juce::String generateBandGainParamString(int bandNum);
+
+juce::String generateBandMuteParamString(int bandNum);
+
+juce::String generateBandSoloParamString(int bandNum);
+
+juce::String generateCpuBudgetParamString();
+
 
 
 
@@ -241,17 +319,100 @@ public:
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
     
     void updateFilterParams();
-
+    
+    void updateCrossoverParams();
+    
+    void applyQualityLevel(int level);
+    
+    //the Peak/shelf band through the chains or, dynamic, through dynamicBand. buffer is processBlock's, for the sidechain
+    void processBand(bool dynamic, juce::dsp::AudioBlock<float>& block, juce::AudioBuffer<float>& buffer);
+    
+    //analyzer feed for the editor. Only filled while an editor is open, so closed instances don't pay for it.
+    static constexpr int analyzerFftOrder = 11;
+    SampleFifo analyzerFifo;
+    std::atomic<bool> analyzerEnabled {false};
+    
+    //steps optional work down under CPU pressure, the editor shows where it's at. See CpuGovernor.h
+    CpuGovernor cpuGovernor;
+    
 private:
     
     using Filter = juce::dsp::IIR::Filter<float>;
     
     using Filterchain = juce::dsp::ProcessorChain<Filter>;
     
-    Filterchain leftChain, rightChain;
+    /*Everything processBlock needs, built on the first prepareToPlay. A host scan constructs us, reads the parameters
+     and destroys us again without ever preparing, so it shouldn't pay for any of this.*/
+    struct DspState
+    {
+        Filterchain leftChain, rightChain;
+        
+        //LowPass and HighPass run through this instead of the chains, at whatever order the slope asks for
+        CascadeFilter cutFilter;
+        SlopeDesign::Sections cutSections;
+        bool cutFilterActive {false};
+        
+        HighCutLowCutParameters existingHighLow;
+        FilterParameters existingFilterParams;
+        //the two structs above can't tell when we've switched between a cut and a non-cut type
+        int existingType {-1};
+        
+        //Peak and shelves run through this instead of the chains when the band is dynamic, see DynamicBand.h
+        DynamicBand dynamicBand;
+        bool dynamicBandActive {false};
+        
+        //which analog matched design the Peak/shelf runs, for the static band and the dynamic one alike
+        MatchedDesign::MethodPicker methodPicker;
+        
+        /*Toggling dynamic swaps between the chains and dynamicBand, which don't share filter state. For
+         dynamicCrossfadeMs both run, the one being entered starting from cleared state, and the output fades across.*/
+        static constexpr double dynamicCrossfadeMs = 10.0;
+        bool dynamicBandWasActive {false};
+        int dynamicCrossfadeLength {0};
+        int dynamicCrossfadeRemaining {0};
+        juce::AudioBuffer<float> crossfadeBuffer;
+        
+        juce::dsp::Gain<float> outputGain;
+        
+        //analytic loudness of the current curve, see AutoGain.h
+        AutoGain autoGain;
+        
+        //multiband split after the EQ, see Crossover.h
+        Crossover crossover;
+    };
+    
+    std::unique_ptr<DspState> dsp;
+    
+    //looked up once in the constructor, so the audio thread never builds a parameter ID string
+    struct ParameterValues
+    {
+        std::atomic<float>* freq {nullptr};
+        std::atomic<float>* quality {nullptr};
+        std::atomic<float>* gain {nullptr};
+        std::atomic<float>* type {nullptr};
+        std::atomic<float>* bypass {nullptr};
+        std::atomic<float>* slope {nullptr};
+        std::atomic<float>* response {nullptr};
+        std::atomic<float>* design {nullptr};
+        std::atomic<float>* dynamic {nullptr};
+        std::atomic<float>* threshold {nullptr};
+        std::atomic<float>* ratio {nullptr};
+        std::atomic<float>* attack {nullptr};
+        std::atomic<float>* release {nullptr};
+        std::atomic<float>* sidechain {nullptr};
+        std::atomic<float>* autoGain {nullptr};
+        
+        std::atomic<float>* crossoverEnabled {nullptr};
+        std::atomic<float>* numBands {nullptr};
+        std::array<std::atomic<float>*, Crossover::maxBands - 1> crossoverFreqs {};
+        std::array<std::atomic<float>*, Crossover::maxBands> bandGains {};
+        std::array<std::atomic<float>*, Crossover::maxBands> bandMutes {};
+        std::array<std::atomic<float>*, Crossover::maxBands> bandSolos {};
+        
+        std::atomic<float>* cpuBudget {nullptr};
+    };
     
-    HighCutLowCutParameters existingHighLow;
-    FilterParameters existingFilterParams;
+    ParameterValues parameterValues;
    
     
     
@@ -0,0 +1,407 @@
+/*
+  ==============================================================================
+
+    ResponseCurveComponent.cpp
+    Created: 18 Oct 2026 9:12:40am
+    Author:  Marc Woodbury-Smith
+
+  ==============================================================================
+*/
+
+#include "ResponseCurveComponent.h"
+#include "Trace.h"
+
+ResponseCurveComponent::ResponseCurveComponent(Project11AudioProcessor& p) : audioProcessor(p)
+{
+    freqParam = audioProcessor.apvts.getParameter(generateFreqParamString(0));
+    gainParam = audioProcessor.apvts.getParameter(generateGainParamString(0));
+
+    for (auto* param : audioProcessor.getParameters())
+    {
+        param->addListener(this);
+    }
+
+    const auto fftSize = 1 << Project11AudioProcessor::analyzerFftOrder;
+    analyzerBuffer.setSize(1, fftSize, false, true, true);
+    fftData.resize(static_cast<size_t>(fftSize * 2), 0.f);
+
+    setOpaque(true);
+}
+
+ResponseCurveComponent::~ResponseCurveComponent()
+{
+    for (auto* param : audioProcessor.getParameters())
+    {
+        param->removeListener(this);
+    }
+}
+
+//==============================================================================
+
+void ResponseCurveComponent::parameterValueChanged(int parameterIndex, float newValue)
+{
+    curveDirty.store(true);
+}
+
+void ResponseCurveComponent::onVBlank()
+{
+    bool needsRepaint = false;
+
+    if (curveDirty.exchange(false))
+    {
+        updateResponseCurve();
+        needsRepaint = true;
+    }
+
+    if (updateAnalyzer())
+    {
+        needsRepaint = true;
+    }
+
+    //nothing changed since the last frame, so there's nothing to paint
+    if (needsRepaint)
+    {
+        repaint(getRenderArea());
+    }
+}
+
+//==============================================================================
+
+juce::Rectangle<int> ResponseCurveComponent::getRenderArea() const
+{
+    //room for the dB labels on the left and the frequency labels underneath
+    return getLocalBounds().withTrimmedLeft(32).withTrimmedBottom(18).reduced(4);
+}
+
+float ResponseCurveComponent::mapFreqToX(float freq) const
+{
+    auto area = getRenderArea().toFloat();
+    return area.getX() + area.getWidth() * juce::mapFromLog10(juce::jlimit(minFreq, maxFreq, freq), minFreq, maxFreq);
+}
+
+float ResponseCurveComponent::mapDbToY(float db) const
+{
+    auto area = getRenderArea().toFloat();
+    return juce::jmap(db, -maxDb, maxDb, area.getBottom(), area.getY());
+}
+
+bool ResponseCurveComponent::currentTypeHasGain() const
+{
+    using namespace FilterInfo;
+
+    auto type = static_cast<FilterType>(static_cast<int>(audioProcessor.apvts.getRawParameterValue(generateTypeParamString(0))->load()));
+    return type == LowShelf || type == HighShelf || type == Peak;
+}
+
+juce::Point<float> ResponseCurveComponent::getNodePosition() const
+{
+    auto freq = audioProcessor.apvts.getRawParameterValue(generateFreqParamString(0))->load();
+    auto gain = currentTypeHasGain() ? audioProcessor.apvts.getRawParameterValue(generateGainParamString(0))->load() : 0.f;
+
+    return { mapFreqToX(freq), mapDbToY(gain) };
+}
+
+//==============================================================================
+
+void ResponseCurveComponent::renderStaticLayer()
+{
+    const auto scale = juce::Component::getApproximateScaleFactorForComponent(this);
+    const auto width = juce::jmax(1, juce::roundToInt(getWidth() * scale));
+    const auto height = juce::jmax(1, juce::roundToInt(getHeight() * scale));
+
+    staticLayer = juce::Image(juce::Image::RGB, width, height, true);
+
+    juce::Graphics g(staticLayer);
+    g.addTransform(juce::AffineTransform::scale(scale));
+
+    g.fillAll(juce::Colours::black);
+
+    auto area = getRenderArea().toFloat();
+
+    g.setColour(juce::Colours::darkgrey.darker());
+    g.fillRect(area);
+
+    const float freqs[] { 20.f, 50.f, 100.f, 200.f, 500.f, 1000.f, 2000.f, 5000.f, 10000.f, 20000.f };
+    const float gains[] { -24.f, -12.f, 0.f, 12.f, 24.f };
+
+    g.setFont(10.f);
+
+    for (auto freq : freqs)
+    {
+        auto x = mapFreqToX(freq);
+        g.setColour(juce::Colours::dimgrey);
+        g.drawVerticalLine(juce::roundToInt(x), area.getY(), area.getBottom());
+
+        juce::String label = freq >= 1000.f ? juce::String(freq / 1000.f) + "k" : juce::String(freq);
+        g.setColour(juce::Colours::lightgrey);
+        g.drawFittedText(label, juce::Rectangle<int>(0, 0, 30, 14).withCentre({ juce::roundToInt(x), getHeight() - 9 }),
+                         juce::Justification::centred, 1);
+    }
+
+    for (auto gain : gains)
+    {
+        auto y = mapDbToY(gain);
+        g.setColour(gain == 0.f ? juce::Colours::grey : juce::Colours::dimgrey);
+        g.drawHorizontalLine(juce::roundToInt(y), area.getX(), area.getRight());
+
+        g.setColour(juce::Colours::lightgrey);
+        g.drawFittedText(juce::String(gain), juce::Rectangle<int>(0, 0, 28, 14).withCentre({ 16, juce::roundToInt(y) }),
+                         juce::Justification::centredRight, 1);
+    }
+}
+
+void ResponseCurveComponent::updateResponseCurve()
+{
+    Trace::Scope scope {"updateResponseCurve"};
+    
+    using namespace FilterInfo;
+
+    auto& apvts = audioProcessor.apvts;
+
+    auto freq = apvts.getRawParameterValue(generateFreqParamString(0))->load();
+    auto q = apvts.getRawParameterValue(generateQParamString(0))->load();
+    auto gain = apvts.getRawParameterValue(generateGainParamString(0))->load();
+    auto type = static_cast<FilterType>(static_cast<int>(apvts.getRawParameterValue(generateTypeParamString(0))->load()));
+    auto bypass = apvts.getRawParameterValue(generateBypassParamString(0))->load() > 0.5f;
+
+    auto sampleRate = audioProcessor.getSampleRate() > 0.0 ? audioProcessor.getSampleRate() : 44100.0;
+
+    //the same designs the processor runs, so the curve is what you hear
+    juce::dsp::IIR::Coefficients<float>::Ptr coefficients;
+    SlopeDesign::Sections cutSections;
+
+    if (!bypass)
+    {
+        if (type == LowPass || type == HighPass)
+        {
+            HighCutLowCutParameters highLow;
+            highLow.isLowcut = (type == HighPass);
+            highLow.frequency = freq;
+            highLow.quality = q;
+            highLow.sampleRate = sampleRate;
+            highLow.order = static_cast<int>(apvts.getRawParameterValue(generateSlopeParamString(0))->load()) + 1;
+            highLow.response = static_cast<SlopeDesign::Response>(static_cast<int>(apvts.getRawParameterValue(generateResponseParamString(0))->load()));
+
+            makeCoefficients(highLow, cutSections);
+        }
+        else
+        {
+            auto analogMatched = apvts.getRawParameterValue(generateDesignParamString(0))->load() > 0.5f;
+            
+            //the pick the processor's MethodPicker lands on; this is the message thread, so it can just pick
+            auto matchedMethod = MatchedDesign::ThreePointFit;
+            if (analogMatched && (type == Peak || type == LowShelf || type == HighShelf))
+            {
+                auto shape = type == Peak ? MatchedDesign::Peak : (type == LowShelf ? MatchedDesign::LowShelf : MatchedDesign::HighShelf);
+                matchedMethod = MatchedDesign::pickMethod(shape, freq, q, gain, sampleRate);
+            }
+            
+            coefficients = makeCoefficients(type, freq, q, gain, static_cast<float>(sampleRate), analogMatched, matchedMethod);
+        }
+    }
+
+    auto area = getRenderArea();
+    const auto width = area.getWidth();
+
+    responseCurve.clear();
+    responseCurve.preallocateSpace(width * 3);
+
+    for (int x = 0; x < width; ++x)
+    {
+        auto pixelFreq = juce::mapToLog10(static_cast<double>(x) / static_cast<double>(juce::jmax(1, width - 1)),
+                                          static_cast<double>(minFreq), static_cast<double>(maxFreq));
+
+        double magnitude = SlopeDesign::getMagnitudeForFrequency(cutSections, pixelFreq, sampleRate);
+        if (coefficients != nullptr)
+        {
+            magnitude *= coefficients->getMagnitudeForFrequency(pixelFreq, sampleRate);
+        }
+
+        auto y = mapDbToY(static_cast<float>(juce::Decibels::gainToDecibels(magnitude, -100.0)));
+        auto point = juce::Point<float>(static_cast<float>(area.getX() + x), y);
+
+        if (x == 0)
+            responseCurve.startNewSubPath(point);
+        else
+            responseCurve.lineTo(point);
+    }
+}
+
+bool ResponseCurveComponent::updateAnalyzer()
+{
+    Trace::Scope scope {"updateAnalyzer"};
+    
+    auto& fifo = audioProcessor.analyzerFifo;
+
+    if (!fifo.isPrepared() || fifo.getSize() != analyzerBuffer.getNumSamples())
+        return false;
+
+    //only the newest block is worth drawing, older ones are just drained
+    bool gotBlock = false;
+    while (fifo.getNumCompleteBuffersAvailable() > 0)
+    {
+        gotBlock = fifo.getAudioBuffer(analyzerBuffer) || gotBlock;
+    }
+
+    if (!gotBlock)
+        return false;
+
+    //a silent block draws the same thing as the last silent block
+    auto silent = analyzerBuffer.getMagnitude(0, 0, analyzerBuffer.getNumSamples()) == 0.f;
+    if (silent && analyzerWasSilent)
+        return false;
+
+    analyzerWasSilent = silent;
+
+    updateAnalyzerPath();
+    return true;
+}
+
+void ResponseCurveComponent::updateAnalyzerPath()
+{
+    const auto fftSize = analyzerBuffer.getNumSamples();
+
+    std::fill(fftData.begin(), fftData.end(), 0.f);
+    std::copy(analyzerBuffer.getReadPointer(0), analyzerBuffer.getReadPointer(0) + fftSize, fftData.begin());
+
+    window.multiplyWithWindowingTable(fftData.data(), static_cast<size_t>(fftSize));
+    fft.performFrequencyOnlyForwardTransform(fftData.data());
+
+    auto area = getRenderArea().toFloat();
+    const auto numBins = fftSize / 2;
+    const auto sampleRate = audioProcessor.getSampleRate() > 0.0 ? audioProcessor.getSampleRate() : 44100.0;
+    const auto binWidth = sampleRate / static_cast<double>(fftSize);
+
+    analyzerPath.clear();
+    analyzerPath.preallocateSpace(static_cast<int>(area.getWidth()) * 3 + 6);
+    analyzerPath.startNewSubPath(area.getX(), area.getBottom());
+
+    //several bins land on the same pixel at the top end, one point per pixel is enough
+    float lastX = area.getX() - 1.f;
+
+    for (int bin = 1; bin < numBins; ++bin)
+    {
+        auto binFreq = static_cast<float>(bin * binWidth);
+        if (binFreq < minFreq || binFreq > maxFreq)
+            continue;
+
+        auto x = mapFreqToX(binFreq);
+        if (x - lastX < 1.f)
+            continue;
+
+        lastX = x;
+
+        auto db = juce::Decibels::gainToDecibels(fftData[static_cast<size_t>(bin)] / static_cast<float>(numBins), -48.f);
+        auto y = juce::jmap(db, -48.f, 0.f, area.getBottom(), area.getY());
+
+        analyzerPath.lineTo(x, y);
+    }
+
+    analyzerPath.lineTo(area.getRight(), area.getBottom());
+    analyzerPath.closeSubPath();
+}
+
+//==============================================================================
+
+void ResponseCurveComponent::paint(juce::Graphics& g)
+{
+    Trace::Scope scope {"paint"};
+
+    g.drawImage(staticLayer, getLocalBounds().toFloat());
+
+    {
+        juce::Graphics::ScopedSaveState state(g);
+        g.reduceClipRegion(getRenderArea());
+
+        g.setColour(juce::Colours::skyblue.withAlpha(0.25f));
+        g.fillPath(analyzerPath);
+
+        g.setColour(juce::Colours::white);
+        g.strokePath(responseCurve, juce::PathStrokeType(2.f));
+
+        auto node = getNodePosition();
+        g.setColour(juce::Colours::orange);
+        g.fillEllipse(juce::Rectangle<float>(nodeRadius * 2.f, nodeRadius * 2.f).withCentre(node));
+    }
+}
+
+void ResponseCurveComponent::resized()
+{
+    renderStaticLayer();
+    updateResponseCurve();
+    analyzerPath.clear();
+    analyzerWasSilent = false;
+}
+
+ResponseCurveComponent::FrameTimes ResponseCurveComponent::renderFramesHeadless(int numFrames)
+{
+    juce::Image frame(juce::Image::RGB, juce::jmax(1, getWidth()), juce::jmax(1, getHeight()), true);
+
+    //a full scale noise block, so the analyzer path has a point on every pixel column like it would with music playing
+    juce::Random random(0x26);
+    for (int i = 0; i < analyzerBuffer.getNumSamples(); ++i)
+        analyzerBuffer.setSample(0, i, random.nextFloat() * 2.f - 1.f);
+
+    FrameTimes result;
+    double totalMs = 0.0;
+
+    for (int i = 0; i < numFrames; ++i)
+    {
+        auto startTicks = juce::Time::getHighResolutionTicks();
+
+        updateResponseCurve();
+        updateAnalyzerPath();
+
+        juce::Graphics g(frame);
+        paintEntireComponent(g, false);
+
+        auto ms = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks) * 1000.0;
+        totalMs += ms;
+        result.worstMs = juce::jmax(result.worstMs, ms);
+    }
+
+    result.meanMs = numFrames > 0 ? totalMs / numFrames : 0.0;
+    return result;
+}
+
+//==============================================================================
+
+void ResponseCurveComponent::mouseDown(const juce::MouseEvent& e)
+{
+    draggingNode = getNodePosition().getDistanceFrom(e.position) <= nodeRadius * 2.f;
+
+    if (draggingNode)
+    {
+        freqParam->beginChangeGesture();
+        gainParam->beginChangeGesture();
+    }
+}
+
+void ResponseCurveComponent::mouseDrag(const juce::MouseEvent& e)
+{
+    if (!draggingNode)
+        return;
+
+    auto area = getRenderArea().toFloat();
+
+    auto normalisedX = juce::jlimit(0.f, 1.f, (e.position.x - area.getX()) / area.getWidth());
+    auto freq = juce::mapToLog10(normalisedX, minFreq, maxFreq);
+    freqParam->setValueNotifyingHost(freqParam->convertTo0to1(freq));
+
+    if (currentTypeHasGain())
+    {
+        auto gain = juce::jmap(juce::jlimit(area.getY(), area.getBottom(), e.position.y), area.getBottom(), area.getY(), -maxDb, maxDb);
+        gainParam->setValueNotifyingHost(gainParam->convertTo0to1(gain));
+    }
+}
+
+void ResponseCurveComponent::mouseUp(const juce::MouseEvent& e)
+{
+    if (draggingNode)
+    {
+        freqParam->endChangeGesture();
+        gainParam->endChangeGesture();
+    }
+
+    draggingNode = false;
+}
@@ -0,0 +1,92 @@
+/*
+  ==============================================================================
+
+    ResponseCurveComponent.h
+    Created: 18 Oct 2026 9:12:40am
+    Author:  Marc Woodbury-Smith
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+/*The EQ display: grid, response curve, analyzer and the draggable band node.
+
+ There is no timer. A VBlankAttachment checks once per display frame whether the parameters or the analyzer data have changed,
+ rebuilds only the path that changed and repaints only then. The grid and labels never change between resizes so they live
+ in a cached image (staticLayer) that paint() just blits.*/
+class ResponseCurveComponent : public juce::Component,
+                               private juce::AudioProcessorParameter::Listener
+{
+public:
+    ResponseCurveComponent(Project11AudioProcessor&);
+    ~ResponseCurveComponent() override;
+
+    void paint(juce::Graphics& g) override;
+    void resized() override;
+
+    void mouseDown(const juce::MouseEvent& e) override;
+    void mouseDrag(const juce::MouseEvent& e) override;
+    void mouseUp(const juce::MouseEvent& e) override;
+
+    struct FrameTimes
+    {
+        double meanMs {0.0};
+        double worstMs {0.0};
+    };
+
+    /*Paints numFrames frames into an offscreen image without needing a window or a display. Every frame rebuilds both
+     dynamic paths, the response curve and the analyzer (from a noise block), which is the worst case onVBlank() can hit.*/
+    FrameTimes renderFramesHeadless(int numFrames);
+
+private:
+    void parameterValueChanged(int parameterIndex, float newValue) override;
+    void parameterGestureChanged(int parameterIndex, bool gestureIsStarting) override {}
+
+    void onVBlank();
+
+    void renderStaticLayer();
+    void updateResponseCurve();
+    bool updateAnalyzer();
+    //FFT of analyzerBuffer into analyzerPath
+    void updateAnalyzerPath();
+
+    juce::Rectangle<int> getRenderArea() const;
+    float mapFreqToX(float freq) const;
+    float mapDbToY(float db) const;
+    juce::Point<float> getNodePosition() const;
+    bool currentTypeHasGain() const;
+
+    Project11AudioProcessor& audioProcessor;
+
+    juce::RangedAudioParameter* freqParam = nullptr;
+    juce::RangedAudioParameter* gainParam = nullptr;
+
+    //set from whatever thread changes a parameter, consumed on the message thread in onVBlank()
+    std::atomic<bool> curveDirty {true};
+
+    juce::Image staticLayer;
+    juce::Path responseCurve;
+    juce::Path analyzerPath;
+
+    juce::dsp::FFT fft {Project11AudioProcessor::analyzerFftOrder};
+    juce::dsp::WindowingFunction<float> window {static_cast<size_t>(1 << Project11AudioProcessor::analyzerFftOrder),
+                                                juce::dsp::WindowingFunction<float>::hann};
+    juce::AudioBuffer<float> analyzerBuffer;
+    std::vector<float> fftData;
+    bool analyzerWasSilent = false;
+
+    bool draggingNode = false;
+
+    static constexpr float nodeRadius = 6.f;
+    static constexpr float maxDb = 24.f;
+    static constexpr float minFreq = 20.f;
+    static constexpr float maxFreq = 20000.f;
+
+    //declared last so it is destroyed first, no callbacks arrive while the members above are being torn down
+    juce::VBlankAttachment vBlankAttachment {this, [this] { onVBlank(); }};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ResponseCurveComponent)
+};
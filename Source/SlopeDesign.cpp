@@ -0,0 +1,277 @@
+/*
+  ==============================================================================
+
+    SlopeDesign.cpp
+    Created: 18 Oct 2026 4:55:31pm
+    Author:  Marc Woodbury-Smith
+
+  ==============================================================================
+*/
+
+#include "SlopeDesign.h"
+#include "Trace.h"
+#include <complex>
+
+namespace SlopeDesign
+{
+
+namespace
+{
+
+using Complex = std::complex<double>;
+
+/*The prototype poles, normalised to a cutoff of 1 rad/s. Only the upper half plane is stored (the conjugates are implied),
+ plus the real pole when the order is odd.*/
+struct Prototype
+{
+    std::array<Complex, maxSections> pairs;
+    int numPairs = 0;
+    bool hasRealPole = false;
+    double realPole = 0.0;
+    double gain = 1.0;
+};
+
+void addButterworth(int order, Prototype& prototype)
+{
+    for (int k = 0; k < order / 2; ++k)
+    {
+        auto theta = juce::MathConstants<double>::pi * (2 * k + 1) / (2.0 * order);
+        prototype.pairs[static_cast<size_t>(prototype.numPairs++)] = Complex(-std::sin(theta), std::cos(theta));
+    }
+
+    if (order % 2 == 1)
+    {
+        prototype.hasRealPole = true;
+        prototype.realPole = -1.0;
+    }
+}
+
+void addChebyshev(int order, double rippleDb, Prototype& prototype)
+{
+    auto epsilon = std::sqrt(std::pow(10.0, rippleDb / 10.0) - 1.0);
+    auto v = std::asinh(1.0 / epsilon) / order;
+
+    for (int k = 0; k < order / 2; ++k)
+    {
+        auto theta = juce::MathConstants<double>::pi * (2 * k + 1) / (2.0 * order);
+        prototype.pairs[static_cast<size_t>(prototype.numPairs++)] = Complex(-std::sinh(v) * std::sin(theta),
+                                                                              std::cosh(v) * std::cos(theta));
+    }
+
+    if (order % 2 == 1)
+    {
+        prototype.hasRealPole = true;
+        prototype.realPole = -std::sinh(v);
+    }
+    else
+    {
+        //even orders start the passband at the bottom of the ripple, pull the peaks down to 0dB
+        prototype.gain = 1.0 / std::sqrt(1.0 + epsilon * epsilon);
+    }
+}
+
+struct BesselPole
+{
+    double re, im;
+};
+
+/*Roots of the reverse Bessel polynomial, sum a_k s^k with a_k = (2n-k)! / (2^(n-k) k! (n-k)!), rescaled so |H| is -3dB
+ at 1 rad/s like the other responses. They don't depend on the cutoff, so rather than finding them on every design they
+ were found once, in long double (Durand-Kerner, polished with Newton), and rounded into this table.
+ Row order - 1: the upper half plane poles, then the real pole when the order is odd.*/
+constexpr std::array<std::array<BesselPole, (maxOrder + 1) / 2>, maxOrder> besselPoles
+{{
+    {{ { -1.0, 0.0 } }},
+    {{ { -1.1016013305921617, 0.63600982475703448 } }},
+    {{ { -1.0474091610089354, 0.99926443628063758 }, { -1.3226757999104448, 0.0 } }},
+    {{ { -0.99520876435027351, 1.2571057394546661 }, { -1.3700678305514442, 0.41024971749375206 } }},
+    {{ { -0.95767654856268193, 1.4711243207303951 }, { -1.3808773258604396, 0.71790958762676845 },
+       { -1.502316271447479, 0.0 } }},
+    {{ { -0.93065652294685865, 1.6618632689425906 }, { -1.3818580975965634, 0.97147189071157098 },
+       { -1.5714904036160308, 0.32089637422262373 } }},
+    {{ { -0.90986778062346975, 1.8364513530363928 }, { -1.3789032167954738, 1.191566777800652 },
+       { -1.6120387662261242, 0.58924450693147147 }, { -1.6843681792731802, 0.0 } }},
+    {{ { -0.89286971884713218, 1.9983258436412951 }, { -1.3738412176373695, 1.3883565758775551 },
+       { -1.6369394181268795, 0.82279562513969532 }, { -1.7574084004016431, 0.2728675751022312 } }},
+    {{ { -0.87839927616095251, 2.1498005243133215 }, { -1.3675883097929051, 1.5677337122372687 },
+       { -1.652396484578835, 1.0313895669844107 }, { -1.8071705349621012, 0.51238373057490397 },
+       { -1.8566005012280033, 0.0 } }},
+    {{ { -0.86575690170837511, 2.2926048309824754 }, { -1.3606922783845438, 1.733505742661476 },
+       { -1.6618102413621518, 1.2211002185791613 }, { -1.842196244524834, 0.72725759775747766 },
+       { -1.9276196913722765, 0.24162347097153326 } }},
+    {{ { -0.85451258135235031, 2.4280594669150577 }, { -1.3534866773880996, 1.8882968447597195 },
+       { -1.6671936422452978, 1.3959629036464658 }, { -1.867361238887205, 0.92311558295185922 },
+       { -1.9801606453037574, 0.45959874382661472 }, { -2.0167014734500258, 0.0 } }},
+    {{ { -0.84437887285039763, 2.5571889692029161 }, { -1.3461746802905147, 2.0339985082784923 },
+       { -1.6698035888528322, 1.5588027008411677 }, { -1.8856496197318586, 1.1038148812152296 },
+       { -2.0199459330751269, 0.65899650071722034 }, { -2.0846445069315826, 0.21916153518975196 } }},
+    {{ { -0.83515201045011014, 2.68080279689105 }, { -1.3388803240827855, 2.1720229471070141 },
+       { -1.6704585626230084, 1.7116782863880771 }, { -1.8989861174802234, 1.2721194365136335 },
+       { -2.0505808760842874, 0.84338310857743049 }, { -2.1376482946235791, 0.42041630675678107 },
+       { -2.1660827056788613, 0.0 } }},
+    {{ { -0.82668133243230727, 2.7995522121727992 }, { -1.3316791973681441, 2.3034553446164313 },
+       { -1.6697101607087761, 1.8561387435992858 }, { -1.9086645751416375, 1.4300797319031636 },
+       { -2.0744515846397843, 1.0153670895905707 }, { -2.1797095206518611, 0.60702982703023746 },
+       { -2.2309307422761165, 0.20200027007624212 } }},
+    {{ { -0.8188518303333102, 2.9139699265276971 }, { -1.3246167600618223, 2.4291497739845204 },
+       { -1.6679408007784386, 1.9933808083267305 }, { -1.9155843465922109, 1.5792603555687844 },
+       { -2.0931997215557231, 1.1769161760930153 }, { -2.2135274873428482, 0.78142997785132188 },
+       { -2.2834265623426824, 0.38982893598523558 }, { -2.3063700566290961, 0.0 } }},
+    {{ { -0.81157346724762067, 3.0244980760211567 }, { -1.3177194372827151, 2.5497920732952534 },
+       { -1.6654219292845743, 2.1243495929990714 }, { -1.9203880948981437, 1.7208833329238061 },
+       { -2.1079908345726118, 1.3295525058466409 }, { -2.2409932226668259, 0.94547404667006021 },
+       { -2.3264790626488147, 0.56573669097058534 }, { -2.3683466817458213, 0.18833295671376724 } }}
+}};
+
+void addBessel(int order, Prototype& prototype)
+{
+    const auto& poles = besselPoles[static_cast<size_t>(order - 1)];
+
+    for (int i = 0; i < order / 2; ++i)
+    {
+        const auto& pole = poles[static_cast<size_t>(i)];
+        prototype.pairs[static_cast<size_t>(prototype.numPairs++)] = Complex(pole.re, pole.im);
+    }
+
+    if (order % 2 == 1)
+    {
+        prototype.hasRealPole = true;
+        prototype.realPole = poles[static_cast<size_t>(order / 2)].re;
+    }
+}
+
+/*Bilinear transform of one normalised prototype section, prewarped so the cutoff lands exactly on freq.
+ k = tan(pi * freq / sampleRate). For a high pass the section is first mirrored with s -> 1/s, which keeps Q and
+ inverts the pole radius.*/
+Section makeSecondOrder(Complex pole, bool isHighPass, double k)
+{
+    auto omega0 = std::abs(pole);
+    auto q = omega0 / (-2.0 * pole.real());
+
+    auto w = isHighPass ? k / omega0 : k * omega0;
+    auto a0 = 1.0 + w / q + w * w;
+
+    Section section;
+    if (isHighPass)
+    {
+        section.b0 = static_cast<float>(1.0 / a0);
+        section.b1 = static_cast<float>(-2.0 / a0);
+        section.b2 = static_cast<float>(1.0 / a0);
+    }
+    else
+    {
+        section.b0 = static_cast<float>(w * w / a0);
+        section.b1 = static_cast<float>(2.0 * w * w / a0);
+        section.b2 = static_cast<float>(w * w / a0);
+    }
+    section.a1 = static_cast<float>((2.0 * w * w - 2.0) / a0);
+    section.a2 = static_cast<float>((1.0 - w / q + w * w) / a0);
+
+    return section;
+}
+
+Section makeFirstOrder(double realPole, bool isHighPass, double k)
+{
+    auto sigma = -realPole;
+    auto w = isHighPass ? k / sigma : k * sigma;
+    auto a0 = 1.0 + w;
+
+    Section section;
+    if (isHighPass)
+    {
+        section.b0 = static_cast<float>(1.0 / a0);
+        section.b1 = static_cast<float>(-1.0 / a0);
+    }
+    else
+    {
+        section.b0 = static_cast<float>(w / a0);
+        section.b1 = static_cast<float>(w / a0);
+    }
+    section.a1 = static_cast<float>((w - 1.0) / a0);
+
+    return section;
+}
+
+} //end anonymous namespace
+
+//==============================================================================
+
+void design(Response response, bool isHighPass, int order, double freq, double sampleRate, Sections& result,
+            double chebyshevRippleDb) noexcept
+{
+    Trace::Scope scope {"SlopeDesign::design"};
+
+    order = juce::jlimit(1, maxOrder, order);
+
+    if (response == LinkwitzRiley && order % 2 == 1)
+        response = Butterworth;
+
+    Prototype prototype;
+
+    switch (response)
+    {
+        case Butterworth:
+            addButterworth(order, prototype);
+            break;
+        case LinkwitzRiley:
+        {
+            //two identical Butterworths of half the order in series
+            addButterworth(order / 2, prototype);
+
+            const auto numButterworthPairs = prototype.numPairs;
+            for (int i = 0; i < numButterworthPairs; ++i)
+                prototype.pairs[static_cast<size_t>(prototype.numPairs++)] = prototype.pairs[static_cast<size_t>(i)];
+
+            //the two real poles of an odd half order make one critically damped pair
+            if (prototype.hasRealPole)
+            {
+                prototype.pairs[static_cast<size_t>(prototype.numPairs++)] = Complex(prototype.realPole, 0.0);
+                prototype.hasRealPole = false;
+            }
+            break;
+        }
+        case Bessel:
+            addBessel(order, prototype);
+            break;
+        case Chebyshev:
+            addChebyshev(order, juce::jmax(0.01, chebyshevRippleDb), prototype);
+            break;
+    }
+
+    auto k = std::tan(juce::MathConstants<double>::pi * juce::jlimit(1.0, sampleRate * 0.49, freq) / sampleRate);
+
+    result.numSections = 0;
+
+    for (int i = 0; i < prototype.numPairs; ++i)
+        result.sections[static_cast<size_t>(result.numSections++)] = makeSecondOrder(prototype.pairs[static_cast<size_t>(i)], isHighPass, k);
+
+    if (prototype.hasRealPole && result.numSections < maxSections)
+        result.sections[static_cast<size_t>(result.numSections++)] = makeFirstOrder(prototype.realPole, isHighPass, k);
+
+    if (prototype.gain != 1.0 && result.numSections > 0)
+    {
+        auto& first = result.sections[0];
+        first.b0 *= static_cast<float>(prototype.gain);
+        first.b1 *= static_cast<float>(prototype.gain);
+        first.b2 *= static_cast<float>(prototype.gain);
+    }
+}
+
+double getMagnitudeForFrequency(const Sections& sections, double freq, double sampleRate) noexcept
+{
+    auto z1 = std::polar(1.0, -juce::MathConstants<double>::twoPi * freq / sampleRate);
+    auto z2 = z1 * z1;
+
+    double magnitude = 1.0;
+
+    for (int i = 0; i < sections.numSections; ++i)
+    {
+        const auto& s = sections.sections[static_cast<size_t>(i)];
+        magnitude *= std::abs((static_cast<double>(s.b0) + static_cast<double>(s.b1) * z1 + static_cast<double>(s.b2) * z2)
+                              / (1.0 + static_cast<double>(s.a1) * z1 + static_cast<double>(s.a2) * z2));
+    }
+
+    return magnitude;
+}
+
+} //end namespace SlopeDesign
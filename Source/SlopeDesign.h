@@ -0,0 +1,69 @@
+/*
+  ==============================================================================
+
+    SlopeDesign.h
+    Created: 18 Oct 2026 4:55:31pm
+    Author:  Marc Woodbury-Smith
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+
+/*Low/high cut design from 6 to 96 dB/Oct (order 1 to 16).
+
+ The analog prototype poles (Butterworth, Linkwitz-Riley, Bessel or Chebyshev type I) are worked out directly, then each
+ conjugate pair (or the single real pole of an odd order) is turned into one second order section with a bilinear transform
+ prewarped at the cutoff. Everything lands in a fixed size Sections struct, so designing never allocates and is safe to do
+ from updateFilterParams() on the audio thread.*/
+namespace SlopeDesign
+{
+
+enum Response
+{
+    Butterworth,
+    LinkwitzRiley,
+    Bessel,
+    Chebyshev
+};
+
+//choice names for the response parameter, indexed by Response
+inline constexpr std::array<const char*, 4> responseNames { "Butterworth", "Linkwitz-Riley", "Bessel", "Chebyshev" };
+
+static constexpr int maxOrder = 16;
+static constexpr int maxSections = maxOrder / 2;
+
+//one biquad in normalised form (a0 == 1). First order sections just leave b2 and a2 at 0.
+struct Section
+{
+    float b0 = 1.f, b1 = 0.f, b2 = 0.f, a1 = 0.f, a2 = 0.f;
+};
+
+inline bool operator==(const Section& lhs, const Section& rhs)
+{
+    return lhs.b0 == rhs.b0 && lhs.b1 == rhs.b1 && lhs.b2 == rhs.b2 && lhs.a1 == rhs.a1 && lhs.a2 == rhs.a2;
+}
+
+struct Sections
+{
+    std::array<Section, maxSections> sections;
+    int numSections = 0;
+};
+
+inline int slopeToOrder(int dbPerOct)
+{
+    return juce::jlimit(1, maxOrder, dbPerOct / 6);
+}
+
+/*isHighPass == true is a low cut.
+ Linkwitz-Riley only exists for even orders (it is a Butterworth of half the order, squared), odd orders fall back to Butterworth.
+ Chebyshev puts the ripple band edge at freq and keeps the passband between -rippleDb and 0dB.*/
+void design(Response response, bool isHighPass, int order, double freq, double sampleRate, Sections& result,
+            double chebyshevRippleDb = 1.0) noexcept;
+
+//|H| of the whole cascade at freq, for the editor and anything else that needs to look at the curve
+double getMagnitudeForFrequency(const Sections& sections, double freq, double sampleRate) noexcept;
+
+} //end namespace SlopeDesign
@@ -0,0 +1,241 @@
+/*
+  ==============================================================================
+
+    Trace.cpp
+    Created: 19 Oct 2026 4:37:02pm
+    Author:  Marc Woodbury-Smith
+
+  ==============================================================================
+*/
+
+#include "Trace.h"
+#include <chrono>
+
+namespace Trace
+{
+
+namespace
+{
+
+struct Event
+{
+    const char* name;
+    juce::int64 start;
+    juce::int64 duration;
+};
+
+/*One ring slot. The flush reads slots the recording thread may be overwriting, so every field is an atomic (relaxed,
+ they're plain loads and stores on anything we build for) and sequence says which event the slot holds: 0 while it's
+ being written, event index + 1 once it's published. A seqlock, in other words: the flush reads sequence, the fields,
+ then sequence again, and only keeps the event if both reads name the one it was after.*/
+struct Slot
+{
+    std::atomic<juce::uint64> sequence {0};
+    std::atomic<const char*> name {nullptr};
+    std::atomic<juce::int64> start {0};
+    std::atomic<juce::int64> duration {0};
+};
+
+static constexpr int maxThreads = 16;
+//power of two so the indices can run on forever and be masked. At a few events per block that's ~10s of audio thread.
+static constexpr juce::uint64 eventsPerThread = 1 << 14;
+
+struct ThreadBuffer
+{
+    std::array<Slot, eventsPerThread> slots;
+    std::atomic<juce::uint64> writeIndex {0};
+    //only the flush touches this, and only one flush runs at a time
+    juce::uint64 readIndex {0};
+    juce::uint64 overwritten {0};
+
+    std::atomic<const char*> threadName {nullptr};
+    std::atomic<bool> isMessageThread {false};
+};
+
+struct Pool
+{
+    std::array<ThreadBuffer, maxThreads> buffers;
+    std::atomic<int> numClaimed {0};
+};
+
+//allocated once by setEnabled(true) and kept for good, recording threads hold raw pointers into it
+std::atomic<Pool*> pool {nullptr};
+std::atomic<bool> flushing {false};
+
+thread_local ThreadBuffer* localBuffer = nullptr;
+thread_local bool poolExhausted = false;
+
+ThreadBuffer* getLocalBuffer() noexcept
+{
+    if (localBuffer != nullptr || poolExhausted)
+        return localBuffer;
+
+    auto* p = pool.load(std::memory_order_acquire);
+    if (p == nullptr)
+        return nullptr;
+
+    const auto index = p->numClaimed.fetch_add(1);
+    if (index >= maxThreads)
+    {
+        poolExhausted = true;
+        return nullptr;
+    }
+
+    localBuffer = &p->buffers[static_cast<size_t>(index)];
+    localBuffer->isMessageThread.store(juce::MessageManager::existsAndIsCurrentThread());
+    return localBuffer;
+}
+
+void writeJson(juce::OutputStream& out, const std::vector<std::pair<int, Event>>& events, const Pool& p, int numThreads)
+{
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+
+    bool first = true;
+    auto separator = [&]
+    {
+        if (! first)
+            out << ",\n";
+        first = false;
+    };
+
+    for (int tid = 0; tid < numThreads; ++tid)
+    {
+        const auto& buffer = p.buffers[static_cast<size_t>(tid)];
+        juce::String name = buffer.isMessageThread ? "Message thread" : "Thread " + juce::String(tid);
+        if (auto* custom = buffer.threadName.load())
+            name = custom;
+
+        if (buffer.overwritten > 0)
+            name << " (" << juce::String(buffer.overwritten) << " overwritten)";
+
+        separator();
+        out << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << tid
+            << ",\"args\":{\"name\":\"" << name << "\"}}";
+    }
+
+    //Chrome wants microseconds, fractions are fine
+    for (const auto& [tid, event] : events)
+    {
+        separator();
+        out << "{\"ph\":\"X\",\"name\":\"" << event.name << "\",\"pid\":1,\"tid\":" << tid
+            << ",\"ts\":" << juce::String(static_cast<double>(event.start) * 1.0e-3, 3)
+            << ",\"dur\":" << juce::String(static_cast<double>(event.duration) * 1.0e-3, 3) << "}";
+    }
+
+    out << "\n]}\n";
+}
+
+} //end anonymous namespace
+
+//==============================================================================
+
+juce::int64 now() noexcept
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void setEnabled(bool shouldBeEnabled)
+{
+    if (shouldBeEnabled && pool.load() == nullptr)
+    {
+        //leaked on purpose: a thread can be halfway through record() at shutdown
+        pool.store(new Pool(), std::memory_order_release);
+    }
+
+    detail::enabled.store(shouldBeEnabled);
+}
+
+void record(const char* name, juce::int64 startNs, juce::int64 endNs) noexcept
+{
+    auto* buffer = getLocalBuffer();
+    if (buffer == nullptr)
+        return;
+
+    //never waits on the flush: once the ring is full the oldest events go, so a flush after a glitch still has the
+    //seconds leading up to it
+    const auto write = buffer->writeIndex.load(std::memory_order_relaxed);
+    auto& slot = buffer->slots[write & (eventsPerThread - 1)];
+
+    slot.sequence.store(0, std::memory_order_relaxed);
+    //the fields can't become visible before the slot is marked as being written
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.start.store(startNs, std::memory_order_relaxed);
+    slot.duration.store(endNs - startNs, std::memory_order_relaxed);
+
+    slot.sequence.store(write + 1, std::memory_order_release);
+    buffer->writeIndex.store(write + 1, std::memory_order_release);
+}
+
+void setThreadName(const char* name) noexcept
+{
+    if (! isEnabled())
+        return;
+
+    if (auto* buffer = getLocalBuffer())
+        buffer->threadName.store(name, std::memory_order_relaxed);
+}
+
+bool flushToFile(const juce::File& file, std::function<void(bool)> onFinished)
+{
+    auto* p = pool.load(std::memory_order_acquire);
+    if (p == nullptr || flushing.exchange(true))
+        return false;
+
+    juce::Thread::launch([p, file, onFinished = std::move(onFinished)]
+    {
+        const auto numThreads = juce::jmin(maxThreads, p->numClaimed.load());
+
+        std::vector<std::pair<int, Event>> events;
+        for (int tid = 0; tid < numThreads; ++tid)
+        {
+            auto& buffer = p->buffers[static_cast<size_t>(tid)];
+            const auto write = buffer.writeIndex.load(std::memory_order_acquire);
+            const auto oldest = write > eventsPerThread ? write - eventsPerThread : 0;
+            const auto read = juce::jmax(buffer.readIndex, oldest);
+            buffer.overwritten += read - buffer.readIndex;
+
+            for (auto i = read; i != write; ++i)
+            {
+                const auto& slot = buffer.slots[i & (eventsPerThread - 1)];
+
+                //the thread kept recording while we copied; a slot it lapped, or is writing right now, no longer holds
+                //event i, so it counts as overwritten
+                const auto sequence = slot.sequence.load(std::memory_order_acquire);
+
+                Event event { slot.name.load(std::memory_order_relaxed),
+                              slot.start.load(std::memory_order_relaxed),
+                              slot.duration.load(std::memory_order_relaxed) };
+
+                std::atomic_thread_fence(std::memory_order_acquire);
+
+                if (sequence == i + 1 && slot.sequence.load(std::memory_order_relaxed) == sequence)
+                    events.emplace_back(tid, event);
+                else
+                    ++buffer.overwritten;
+            }
+
+            buffer.readIndex = write;
+        }
+
+        bool ok = false;
+        file.deleteFile();
+        juce::FileOutputStream out(file);
+        if (out.openedOk())
+        {
+            writeJson(out, events, *p, numThreads);
+            out.flush();
+            ok = ! out.getStatus().failed();
+        }
+
+        flushing.store(false);
+
+        if (onFinished != nullptr)
+            onFinished(ok);
+    });
+
+    return true;
+}
+
+} //end namespace Trace
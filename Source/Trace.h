@@ -0,0 +1,79 @@
+/*
+  ==============================================================================
+
+    Trace.h
+    Created: 19 Oct 2026 4:37:02pm
+    Author:  Marc Woodbury-Smith
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+#include <functional>
+
+/*Scoped event recording, for lining up processBlock spikes with redesigns, state loads and repaints.
+
+ Put a Trace::Scope at the top of anything worth seeing:
+
+     Trace::Scope scope {"updateFilterParams"};
+
+ Off (the default), a scope is one relaxed atomic load. On, it's two clock reads and a write into a ring buffer owned
+ by the calling thread: single producer (that thread), single consumer (the flush), no locks, no allocation. Threads
+ claim a ring out of a fixed pool the first time they record; the pool is allocated by setEnabled(true) on the message
+ thread, never by a recording thread. The rings are flight recorders: when one is full the oldest events are
+ overwritten, the recording thread never waits.
+
+ flushToFile() drains every ring on a background thread and writes Chrome trace event JSON, which chrome://tracing and
+ ui.perfetto.dev both open.*/
+namespace Trace
+{
+
+//nanoseconds on a monotonic clock
+juce::int64 now() noexcept;
+
+void setEnabled(bool shouldBeEnabled);
+
+namespace detail
+{
+inline std::atomic<bool> enabled {false};
+}
+
+inline bool isEnabled() noexcept
+{
+    return detail::enabled.load(std::memory_order_relaxed);
+}
+
+//name must outlive the trace, pass a string literal
+void record(const char* name, juce::int64 startNs, juce::int64 endNs) noexcept;
+
+//labels the calling thread in the viewer. Literal again; the message thread labels itself.
+void setThreadName(const char* name) noexcept;
+
+class Scope
+{
+public:
+    explicit Scope(const char* nameToUse) noexcept
+        : name(nameToUse), start(isEnabled() ? now() : -1)
+    {
+    }
+
+    ~Scope()
+    {
+        if (start >= 0)
+            record(name, start, now());
+    }
+
+private:
+    const char* name;
+    juce::int64 start;
+
+    JUCE_DECLARE_NON_COPYABLE(Scope)
+};
+
+/*Drains everything recorded so far into file on a background thread and calls onFinished (from that thread) with
+ whether it worked. Returns false without doing anything if a flush is still running.*/
+bool flushToFile(const juce::File& file, std::function<void(bool)> onFinished = nullptr);
+
+} //end namespace Trace